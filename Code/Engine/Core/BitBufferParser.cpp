@@ -0,0 +1,138 @@
+#include "Engine/Core/BitBufferParser.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <cmath>
+
+// The range BitBufferWriter accepts; it also keeps the 1u << numBits below well defined
+static void ValidateQuantizedNumBits(int numBits)
+{
+	if (numBits < 1 || numBits > 24)
+	{
+		throw std::runtime_error("BitBufferParser quantized values take 1 to 24 bits");
+	}
+}
+
+BitBufferParser::BitBufferParser(const void* data, size_t size)
+	: m_data(static_cast<const byte_t*>(data)), m_size(size)
+{
+}
+
+uint64_t BitBufferParser::ParseBits(int numBits)
+{
+	if (numBits < 0 || numBits > 64 || static_cast<size_t>(numBits) > GetNumBitsRemaining())
+	{
+		throw std::runtime_error("BitBufferParser read out of bounds");
+	}
+
+	uint64_t value = 0;
+	int numBitsRead = 0;
+	while (numBitsRead < numBits)
+	{
+		int bitInByte = static_cast<int>(m_bitOffset & 7);
+		int bitsThisByte = 8 - bitInByte;
+		if (bitsThisByte > numBits - numBitsRead)
+		{
+			bitsThisByte = numBits - numBitsRead;
+		}
+
+		uint64_t bits = (m_data[m_bitOffset >> 3] >> bitInByte) & ((1u << bitsThisByte) - 1);
+		value |= bits << numBitsRead;
+
+		numBitsRead += bitsThisByte;
+		m_bitOffset += bitsThisByte;
+	}
+	return value;
+}
+
+bool BitBufferParser::ParseBool()
+{
+	return ParseBits(1) != 0;
+}
+
+int BitBufferParser::ParseRangedInt(int minValue, int maxValue)
+{
+	uint64_t numValues = static_cast<uint64_t>(static_cast<int64_t>(maxValue) - minValue) + 1;
+	uint64_t offset = ParseBits(GetNumBitsForValueCount(numValues));
+	if (offset >= numValues)
+	{
+		throw std::runtime_error("BitBufferParser ranged int out of range");
+	}
+	return static_cast<int>(static_cast<int64_t>(minValue) + static_cast<int64_t>(offset));
+}
+
+uint32_t BitBufferParser::ParseVarUInt()
+{
+	uint64_t value = ParseVarUInt64();
+	if (value > 0xFFFFFFFFull)
+	{
+		throw std::runtime_error("BitBufferParser varint too large");
+	}
+	return static_cast<uint32_t>(value);
+}
+
+int32_t BitBufferParser::ParseVarInt()
+{
+	return static_cast<int32_t>(ZigZagDecode(ParseVarUInt()));
+}
+
+uint64_t BitBufferParser::ParseVarUInt64()
+{
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		uint64_t group = ParseBits(8);
+		value |= (group & 0x7F) << shift;
+		if ((group & 0x80) == 0)
+		{
+			return value;
+		}
+	}
+	throw std::runtime_error("BitBufferParser varint too long");
+}
+
+int64_t BitBufferParser::ParseVarInt64()
+{
+	return ZigZagDecode(ParseVarUInt64());
+}
+
+float BitBufferParser::ParseFloat()
+{
+	uint32_t bits = static_cast<uint32_t>(ParseBits(32));
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+float BitBufferParser::ParseQuantizedFloat(float minValue, float maxValue, int numBits)
+{
+	ValidateQuantizedNumBits(numBits);
+	float maxStep = static_cast<float>((1u << numBits) - 1);
+	float step = static_cast<float>(ParseBits(numBits));
+	return RangeMap(step, 0.f, maxStep, minValue, maxValue);
+}
+
+Vec2 BitBufferParser::ParseUnitVec2(int numBits)
+{
+	ValidateQuantizedNumBits(numBits);
+	float step = static_cast<float>(ParseBits(numBits));
+	return Vec2::MakeFromPolarDegrees(step * (360.f / static_cast<float>(1u << numBits)));
+}
+
+Vec3 BitBufferParser::ParseUnitVec3(int bitsPerComponent)
+{
+	float octX = ParseQuantizedFloat(-1.f, 1.f, bitsPerComponent);
+	float octY = ParseQuantizedFloat(-1.f, 1.f, bitsPerComponent);
+
+	// Unfold the lower hemisphere (see BitBufferWriter::AppendUnitVec3)
+	Vec3 direction(octX, octY, 1.f - fabsf(octX) - fabsf(octY));
+	float fold = (direction.z < 0.f) ? -direction.z : 0.f;
+	direction.x += (direction.x >= 0.f) ? -fold : fold;
+	direction.y += (direction.y >= 0.f) ? -fold : fold;
+	return direction.GetNormalized();
+}
+
+void BitBufferParser::AlignToByte()
+{
+	m_bitOffset = GetByteOffset() * 8;
+}
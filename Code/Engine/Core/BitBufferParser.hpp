@@ -0,0 +1,41 @@
+#pragma once
+#include "Engine/Core/BufferUtils.hpp"
+#include <stdexcept>
+
+struct Vec2;
+struct Vec3;
+
+
+//------------------------------------------------------------------------------------------------
+// Reads a BitBufferWriter stream back; call the matching Parse for each Append, with the same ranges and
+// bit counts. Throws std::runtime_error when a read runs past the end or a varint is malformed, like BufferParser.
+class BitBufferParser
+{
+public:
+	BitBufferParser(const void* data, size_t size);
+
+	uint64_t ParseBits(int numBits); // 0..64
+	bool	 ParseBool();
+	int		 ParseRangedInt(int minValue, int maxValue);
+
+	uint32_t ParseVarUInt();
+	int32_t  ParseVarInt();
+	uint64_t ParseVarUInt64();
+	int64_t  ParseVarInt64();
+
+	float	 ParseFloat();
+	float	 ParseQuantizedFloat(float minValue, float maxValue, int numBits);
+	Vec2	 ParseUnitVec2(int numBits);
+	Vec3	 ParseUnitVec3(int bitsPerComponent);
+
+	void	 AlignToByte(); // Skips to the next byte boundary, matching BitBufferWriter::AlignToByte
+
+	size_t GetBitOffset() const { return m_bitOffset; }
+	size_t GetByteOffset() const { return (m_bitOffset + 7) / 8; } // Where the next byte-aligned data starts
+	size_t GetNumBitsRemaining() const { return m_size * 8 - m_bitOffset; }
+
+private:
+	const byte_t* m_data = nullptr;
+	size_t m_size = 0;
+	size_t m_bitOffset = 0;
+};
@@ -0,0 +1,147 @@
+#include "Engine/Core/BitBufferWriter.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <cmath>
+
+BitBufferWriter::BitBufferWriter(std::vector<byte_t>& buffer)
+	: m_buffer(buffer)
+{
+}
+
+void BitBufferWriter::AppendBits(uint64_t value, int numBits)
+{
+	ASSERT_OR_DIE(numBits >= 0 && numBits <= 64, "BitBufferWriter::AppendBits takes 0 to 64 bits");
+	m_numBitsWritten += numBits;
+
+	while (numBits > 0)
+	{
+		if (m_bitsUsedInLastByte == 8)
+		{
+			m_buffer.push_back(0);
+			m_bitsUsedInLastByte = 0;
+		}
+
+		int bitsThisByte = 8 - m_bitsUsedInLastByte;
+		if (bitsThisByte > numBits)
+		{
+			bitsThisByte = numBits;
+		}
+		byte_t bits = static_cast<byte_t>(value & ((1u << bitsThisByte) - 1));
+		m_buffer.back() |= static_cast<byte_t>(bits << m_bitsUsedInLastByte);
+
+		m_bitsUsedInLastByte += bitsThisByte;
+		value >>= bitsThisByte;
+		numBits -= bitsThisByte;
+	}
+}
+
+void BitBufferWriter::AppendBool(bool value)
+{
+	AppendBits(value ? 1 : 0, 1);
+}
+
+void BitBufferWriter::AppendRangedInt(int value, int minValue, int maxValue)
+{
+	ASSERT_OR_DIE(minValue <= maxValue, "BitBufferWriter::AppendRangedInt needs minValue <= maxValue");
+	if (value < minValue)
+	{
+		value = minValue;
+	}
+	if (value > maxValue)
+	{
+		value = maxValue;
+	}
+
+	uint64_t numValues = static_cast<uint64_t>(static_cast<int64_t>(maxValue) - minValue) + 1;
+	AppendBits(static_cast<uint64_t>(static_cast<int64_t>(value) - minValue), GetNumBitsForValueCount(numValues));
+}
+
+void BitBufferWriter::AppendVarUInt(uint32_t value)
+{
+	AppendVarUInt64(value);
+}
+
+void BitBufferWriter::AppendVarInt(int32_t value)
+{
+	AppendVarUInt64(ZigZagEncode(value));
+}
+
+void BitBufferWriter::AppendVarUInt64(uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		AppendBits((value & 0x7F) | 0x80, 8);
+		value >>= 7;
+	}
+	AppendBits(value, 8);
+}
+
+void BitBufferWriter::AppendVarInt64(int64_t value)
+{
+	AppendVarUInt64(ZigZagEncode(value));
+}
+
+void BitBufferWriter::AppendFloat(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	AppendBits(bits, 32);
+}
+
+void BitBufferWriter::AppendQuantizedFloat(float value, float minValue, float maxValue, int numBits)
+{
+	ASSERT_OR_DIE(numBits >= 1 && numBits <= 24, "BitBufferWriter::AppendQuantizedFloat takes 1 to 24 bits");
+	float maxStep = static_cast<float>((1u << numBits) - 1);
+	int step = RoundDownToInt(RangeMapClamped(value, minValue, maxValue, 0.f, maxStep) + 0.5f);
+	AppendBits(static_cast<uint64_t>(step), numBits);
+}
+
+void BitBufferWriter::AppendUnitVec2(Vec2 const& direction, int numBits)
+{
+	ASSERT_OR_DIE(numBits >= 1 && numBits <= 24, "BitBufferWriter::AppendUnitVec2 takes 1 to 24 bits");
+	float orientationDegrees = direction.GetOrientationDegrees();
+	if (orientationDegrees < 0.f)
+	{
+		orientationDegrees += 360.f;
+	}
+
+	// 360 is the same direction as 0, so the range excludes it and the top step wraps around
+	uint32_t numSteps = 1u << numBits;
+	uint32_t step = static_cast<uint32_t>(RoundDownToInt(orientationDegrees * (static_cast<float>(numSteps) / 360.f) + 0.5f));
+	AppendBits(step % numSteps, numBits);
+}
+
+void BitBufferWriter::AppendUnitVec3(Vec3 const& direction, int bitsPerComponent)
+{
+	// Project onto the octahedron |x| + |y| + |z| = 1 and fold the lower half over the upper one; this spreads
+	// precision evenly over the sphere, unlike quantizing x, y, z (or two angles) directly
+	float sumOfAbsolutes = fabsf(direction.x) + fabsf(direction.y) + fabsf(direction.z);
+	float octX = 0.f;
+	float octY = 0.f;
+	if (sumOfAbsolutes > 0.f)
+	{
+		octX = direction.x / sumOfAbsolutes;
+		octY = direction.y / sumOfAbsolutes;
+		if (direction.z < 0.f)
+		{
+			float foldedX = (1.f - fabsf(octY)) * (octX >= 0.f ? 1.f : -1.f);
+			float foldedY = (1.f - fabsf(octX)) * (octY >= 0.f ? 1.f : -1.f);
+			octX = foldedX;
+			octY = foldedY;
+		}
+	}
+
+	AppendQuantizedFloat(octX, -1.f, 1.f, bitsPerComponent);
+	AppendQuantizedFloat(octY, -1.f, 1.f, bitsPerComponent);
+}
+
+void BitBufferWriter::AlignToByte()
+{
+	if (m_bitsUsedInLastByte != 8)
+	{
+		m_numBitsWritten += 8 - m_bitsUsedInLastByte;
+		m_bitsUsedInLastByte = 8;
+	}
+}
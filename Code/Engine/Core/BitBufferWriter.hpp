@@ -0,0 +1,42 @@
+#pragma once
+#include "Engine/Core/BufferUtils.hpp"
+
+struct Vec2;
+struct Vec3;
+
+
+//------------------------------------------------------------------------------------------------
+// Packs values into as few bits as they need, for replicated state and save payloads: a bool is one bit,
+// a health value known to be 0..200 is eight. Bits fill each byte from its least significant end and bytes
+// are appended in order, so the stream reads back identically on any machine (EndianMode doesn't apply).
+// Starts at the end of whatever is already in the buffer; the last byte is zero padded, so the buffer is
+// always ready to send and BitBufferParser can read it back with the same sequence of calls.
+class BitBufferWriter
+{
+public:
+	explicit BitBufferWriter(std::vector<byte_t>& buffer);
+
+	void AppendBits(uint64_t value, int numBits); // Low numBits (0..64) of value
+	void AppendBool(bool value);
+	void AppendRangedInt(int value, int minValue, int maxValue); // Clamped; GetNumBitsForValueCount(max - min + 1) bits
+
+	// Variable length: 7 bits per group plus a continue bit, so 0..127 costs 8 bits. Signed forms zigzag first.
+	void AppendVarUInt(uint32_t value);
+	void AppendVarInt(int32_t value);
+	void AppendVarUInt64(uint64_t value);
+	void AppendVarInt64(int64_t value);
+
+	void AppendFloat(float value); // Full 32 bits
+	void AppendQuantizedFloat(float value, float minValue, float maxValue, int numBits); // Clamped, rounded to the nearest step
+	void AppendUnitVec2(Vec2 const& direction, int numBits); // Orientation only
+	void AppendUnitVec3(Vec3 const& direction, int bitsPerComponent); // Octahedral: two quantized components
+
+	void AlignToByte(); // Pads with zero bits, e.g. before appending raw bytes to the buffer
+
+	size_t GetNumBitsWritten() const { return m_numBitsWritten; }
+
+private:
+	std::vector<byte_t>& m_buffer;
+	size_t m_numBitsWritten = 0;
+	int m_bitsUsedInLastByte = 8; // 8 means the next bit starts a new byte
+};
@@ -1,239 +1,95 @@
 #include "BufferParser.hpp"
-#include "Engine/Math/Vec2.hpp"
-#include "Engine/Math/IntVec2.hpp"
-#include "Engine/Core/Rgba8.hpp"
-#include "Engine/Core/Vertex_PCU.hpp"
-#include <stdexcept>
 
 BufferParser::BufferParser(const void* data, size_t size, EndianMode mode)
-	: m_data((const byte_t*)data), m_size(size)
+	: m_parser(LittleEndianBufferParser(data, size))
 {
-	if (mode == EndianMode::NATIVE)
+	if (ResolveEndianMode(mode) == EndianMode::BIG)
 	{
-		m_mode = IsMachineLittleEndian() ? EndianMode::LITTLE : EndianMode::BIG;
-	}
-	else
-	{
-		m_mode = mode;
+		m_parser = BigEndianBufferParser(data, size);
 	}
 }
 
-void BufferParser::SetEndianMode(EndianMode mode)
+BufferParser::BufferParser(MappedFile const& file, EndianMode mode)
+	: BufferParser(file.GetData(), file.GetSize(), mode)
 {
-	if (mode == EndianMode::NATIVE)
-	{
-		m_mode = IsMachineLittleEndian() ? EndianMode::LITTLE : EndianMode::BIG;
-	}
-	else
-	{
-		m_mode = mode;
-	}
 }
 
-void BufferParser::ReadBytes(void* outData, size_t size)
+void BufferParser::SetEndianMode(EndianMode mode)
 {
-	if (m_offset + size > m_size)
-		throw std::runtime_error("BufferParser read out of bounds");
-
-	const byte_t* src = m_data + m_offset;
-	byte_t* dst = (byte_t*)outData;
-
-	bool machineLittle = IsMachineLittleEndian();
-	bool wantLittle = (m_mode == EndianMode::LITTLE);
+	if (ResolveEndianMode(mode) == GetEndianMode())
+	{
+		return;
+	}
 
-	if (machineLittle == wantLittle)
+	const byte_t* data = std::visit([](auto& parser) { return parser.GetData(); }, m_parser);
+	size_t size = GetSize();
+	size_t offset = GetOffset();
+	if (ResolveEndianMode(mode) == EndianMode::BIG)
 	{
-		for (size_t i = 0; i < size; ++i) dst[i] = src[i];
+		m_parser = BigEndianBufferParser(data, size);
 	}
 	else
 	{
-		for (size_t i = 0; i < size; ++i) dst[i] = src[size - 1 - i];
+		m_parser = LittleEndianBufferParser(data, size);
 	}
-
-	m_offset += size;
-}
-
-
-
-byte_t BufferParser::ParseByte()
-{
-	byte_t v;
-	ReadBytes(&v, sizeof(v));
-	return v;
-}
-
-char BufferParser::ParseChar()
-{
-	char v;
-	ReadBytes(&v, sizeof(v));
-	return v;
-}
-
-uint16_t BufferParser::ParseUShort()
-{
-	uint16_t v;
-	ReadBytes(&v, sizeof(v));
-	return v;
-}
-
-int16_t BufferParser::ParseShort()
-{
-	int16_t v;
-	ReadBytes(&v, sizeof(v));
-	return v;
-}
-
-uint32_t BufferParser::ParseUInt()
-{
-	uint32_t v;
-	ReadBytes(&v, sizeof(v));
-	return v;
-}
-
-int32_t BufferParser::ParseInt()
-{
-	int32_t v;
-	ReadBytes(&v, sizeof(v));
-	return v;
-}
-
-uint64_t BufferParser::ParseUInt64()
-{
-	uint64_t v;
-	ReadBytes(&v, sizeof(v));
-	return v;
+	JumpToOffset(offset);
 }
 
-int64_t BufferParser::ParseInt64()
-{
-	int64_t v;
-	ReadBytes(&v, sizeof(v));
-	return v;
-}
-
-float BufferParser::ParseFloat()
-{
-	float v;
-	ReadBytes(&v, sizeof(v));
-	return v;
-}
-
-double BufferParser::ParseDouble()
-{
-	double v;
-	ReadBytes(&v, sizeof(v));
-	return v;
-}
-
-bool BufferParser::ParseBool()
-{
-	byte_t b = ParseByte();
-	return b != 0;
-}
+byte_t BufferParser::ParseByte() { return std::visit([](auto& parser) { return parser.ParseByte(); }, m_parser); }
+char BufferParser::ParseChar() { return std::visit([](auto& parser) { return parser.ParseChar(); }, m_parser); }
+uint16_t BufferParser::ParseUShort() { return std::visit([](auto& parser) { return parser.ParseUShort(); }, m_parser); }
+int16_t BufferParser::ParseShort() { return std::visit([](auto& parser) { return parser.ParseShort(); }, m_parser); }
+uint32_t BufferParser::ParseUInt() { return std::visit([](auto& parser) { return parser.ParseUInt(); }, m_parser); }
+int32_t BufferParser::ParseInt() { return std::visit([](auto& parser) { return parser.ParseInt(); }, m_parser); }
+uint64_t BufferParser::ParseUInt64() { return std::visit([](auto& parser) { return parser.ParseUInt64(); }, m_parser); }
+int64_t BufferParser::ParseInt64() { return std::visit([](auto& parser) { return parser.ParseInt64(); }, m_parser); }
+float BufferParser::ParseFloat() { return std::visit([](auto& parser) { return parser.ParseFloat(); }, m_parser); }
+double BufferParser::ParseDouble() { return std::visit([](auto& parser) { return parser.ParseDouble(); }, m_parser); }
+bool BufferParser::ParseBool() { return std::visit([](auto& parser) { return parser.ParseBool(); }, m_parser); }
 
 std::string BufferParser::ParseStringZeroTerminated()
 {
-	std::string result;
-
-	while (true)
-	{
-		if (m_offset >= m_size)
-		{
-			throw std::runtime_error("String parse out of bounds");
-		}
-
-		char c = (char)m_data[m_offset++];
-		if (c == '\0')
-			break;
-
-		result.push_back(c);
-	}
-
-	return result;
+	return std::visit([](auto& parser) { return parser.ParseStringZeroTerminated(); }, m_parser);
 }
 
 std::string BufferParser::ParseStringLengthPreceded()
 {
-	uint32_t length = ParseUInt();
-
-	if (m_offset + length > m_size)
-	{
-		throw std::runtime_error("String length exceeds buffer");
-	}
-
-	std::string result((const char*)(m_data + m_offset), length);
-	m_offset += length;
-
-	return result;
-}
-
-Vec2 BufferParser::ParseVec2()
-{
-	Vec2 v;
-	v.x = ParseFloat();
-	v.y = ParseFloat();
-	return v;
+	return std::visit([](auto& parser) { return parser.ParseStringLengthPreceded(); }, m_parser);
 }
 
-IntVec2 BufferParser::ParseIntVec2()
+std::span<byte_t const> BufferParser::ParseBytesView(size_t numBytes)
 {
-	IntVec2 v;
-	v.x = ParseInt();
-	v.y = ParseInt();
-	return v;
+	return std::visit([numBytes](auto& parser) { return parser.ParseBytesView(numBytes); }, m_parser);
 }
 
-Rgba8 BufferParser::ParseRgba8()
+std::string_view BufferParser::ParseStringViewLengthPreceded()
 {
-	Rgba8 c;
-	c.r = (unsigned char)ParseByte();
-	c.g = (unsigned char)ParseByte();
-	c.b = (unsigned char)ParseByte();
-	c.a = (unsigned char)ParseByte();
-	return c;
+	return std::visit([](auto& parser) { return parser.ParseStringViewLengthPreceded(); }, m_parser);
 }
 
-Rgba8 BufferParser::ParseRgb()
-{
-	Rgba8 c;
-	c.r = (unsigned char)ParseByte();
-	c.g = (unsigned char)ParseByte();
-	c.b = (unsigned char)ParseByte();
-	c.a = 255; 
-	return c;
-}
-Vertex_PCU BufferParser::ParseVertexPCU()
-{
-	Vertex_PCU v;
-
-	v.m_position.x = ParseFloat();
-	v.m_position.y = ParseFloat();
-	v.m_position.z = ParseFloat();
-
-	v.m_color = ParseRgba8();
-
-	v.m_uvTexCoords.x = ParseFloat();
-	v.m_uvTexCoords.y = ParseFloat();
-
-	return v;
-}
+Vec2 BufferParser::ParseVec2() { return std::visit([](auto& parser) { return parser.ParseVec2(); }, m_parser); }
+IntVec2 BufferParser::ParseIntVec2() { return std::visit([](auto& parser) { return parser.ParseIntVec2(); }, m_parser); }
+Rgba8 BufferParser::ParseRgba8() { return std::visit([](auto& parser) { return parser.ParseRgba8(); }, m_parser); }
+Rgba8 BufferParser::ParseRgb() { return std::visit([](auto& parser) { return parser.ParseRgb(); }, m_parser); }
+Vertex_PCU BufferParser::ParseVertexPCU() { return std::visit([](auto& parser) { return parser.ParseVertexPCU(); }, m_parser); }
 
 
 void BufferParser::JumpToOffset(size_t absoluteOffset)
 {
-	if (absoluteOffset > m_size)
-	{
-		throw std::runtime_error("JumpToOffset out of range");
-	}
-	m_offset = absoluteOffset;
+	std::visit([absoluteOffset](auto& parser) { parser.JumpToOffset(absoluteOffset); }, m_parser);
 }
 
 size_t BufferParser::GetOffset() const
 {
-	return m_offset;
+	return std::visit([](auto const& parser) { return parser.GetOffset(); }, m_parser);
 }
 
 size_t BufferParser::GetSize() const
 {
-	return m_size;
+	return std::visit([](auto const& parser) { return parser.GetSize(); }, m_parser);
+}
+
+EndianMode BufferParser::GetEndianMode() const
+{
+	return std::holds_alternative<BigEndianBufferParser>(m_parser) ? EndianMode::BIG : EndianMode::LITTLE;
 }
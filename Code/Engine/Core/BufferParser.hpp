@@ -1,20 +1,115 @@
 #pragma once
 #include "Engine/Core/BufferUtils.hpp"
+#include "Engine/Core/MappedFile.hpp"
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <variant>
 
-struct Vec2;
-struct IntVec2;
-struct Rgba8;
-struct VertexPCU;
 
+//------------------------------------------------------------------------------------------------
+// CHECKED throws std::runtime_error on any read past the end. UNCHECKED drops the per-read bounds test and
+// the exception path entirely; only use it on data whose size has already been validated (a chunk whose
+// header was checked, a cache whose payload size matched). Zero-terminated strings still stop at the end.
+enum class BufferBoundsCheck
+{
+	CHECKED,
+	UNCHECKED
+};
+
+
+//------------------------------------------------------------------------------------------------
+// Byte order fixed at compile time, so native-order reads are a plain memcpy and swapped ones a bswap,
+// with no per-read mode test. Hot loaders should use these directly, e.g.
+//	BasicBufferParser<EndianMode::LITTLE, BufferBoundsCheck::UNCHECKED> parser(chunkData, chunkSize);
+template <EndianMode endian, BufferBoundsCheck boundsCheck = BufferBoundsCheck::CHECKED>
+class BasicBufferParser
+{
+public:
+	static constexpr EndianMode ENDIAN_MODE = ResolveEndianMode(endian);
+	static constexpr bool IS_NATIVE_ORDER = IsNativeEndianMode(endian);
+	static constexpr bool IS_BOUNDS_CHECKED = (boundsCheck == BufferBoundsCheck::CHECKED);
+
+	BasicBufferParser(const void* data, size_t size) : m_data(static_cast<const byte_t*>(data)), m_size(size) {}
+	explicit BasicBufferParser(MappedFile const& file) : m_data(file.GetData()), m_size(file.GetSize()) {} // The file must stay mapped while parsing
+
+	constexpr EndianMode GetEndianMode() const { return ENDIAN_MODE; }
+
+	template <typename T>
+	T ParseValue(); // Any arithmetic type
+
+	byte_t   ParseByte() { return ParseValue<byte_t>(); }
+	char     ParseChar() { return ParseValue<char>(); }
+	uint16_t ParseUShort() { return ParseValue<uint16_t>(); }
+	int16_t  ParseShort() { return ParseValue<int16_t>(); }
+	uint32_t ParseUInt() { return ParseValue<uint32_t>(); }
+	int32_t  ParseInt() { return ParseValue<int32_t>(); }
+	uint64_t ParseUInt64() { return ParseValue<uint64_t>(); }
+	int64_t  ParseInt64() { return ParseValue<int64_t>(); }
+	float    ParseFloat() { return ParseValue<float>(); }
+	double   ParseDouble() { return ParseValue<double>(); }
+	bool	 ParseBool() { return ParseValue<byte_t>() != 0; }
+
+	std::string ParseStringZeroTerminated();
+	std::string ParseStringLengthPreceded();
+
+	// Zero-copy: views into the parsed buffer itself, valid as long as it is
+	std::span<byte_t const> ParseBytesView(size_t numBytes);
+	std::string_view ParseStringViewLengthPreceded();
+
+	Vec2    ParseVec2();
+	IntVec2 ParseIntVec2();
+	Rgba8   ParseRgba8();
+	Rgba8 ParseRgb();
+
+	Vertex_PCU ParseVertexPCU();
+
+	template <typename T>
+	void ParseArray(std::span<T> outElements);
+	template <typename T>
+	void ParseArray(std::vector<T>& outElements, size_t count);
 
+	void JumpToOffset(size_t absoluteOffset);
+	size_t GetOffset() const { return m_offset; }
+	size_t GetSize() const { return m_size; }
+	const byte_t* GetData() const { return m_data; }
+
+private:
+	void RequireBytes(size_t numBytes, char const* errorMessage) const;
+	template <typename T>
+	T LoadValue(size_t offset) const; // No bounds check; the caller has done RequireBytes
+
+private:
+	const byte_t* m_data = nullptr;
+	size_t m_size = 0;
+	size_t m_offset = 0;
+};
+
+typedef BasicBufferParser<EndianMode::LITTLE>									LittleEndianBufferParser;
+typedef BasicBufferParser<EndianMode::BIG>										BigEndianBufferParser;
+typedef BasicBufferParser<EndianMode::LITTLE, BufferBoundsCheck::UNCHECKED>	UncheckedLittleEndianBufferParser;
+typedef BasicBufferParser<EndianMode::BIG, BufferBoundsCheck::UNCHECKED>		UncheckedBigEndianBufferParser;
+
+
+//------------------------------------------------------------------------------------------------
+// Byte order chosen at runtime (and changeable mid-buffer). Each call is forwarded to the matching
+// BasicBufferParser, so the mode is tested once per call rather than once per byte.
 class BufferParser
 {
 public:
 	BufferParser(const void* data, size_t size, EndianMode mode = EndianMode::NATIVE);
+	explicit BufferParser(MappedFile const& file, EndianMode mode = EndianMode::NATIVE); // Parses the mapping in place; keep the file open meanwhile
 
 	void SetEndianMode(EndianMode mode);
 
+	template <typename T>
+	T ParseValue(); // Any arithmetic type
+
 	byte_t   ParseByte();
 	char     ParseChar();
 	uint16_t ParseUShort();
@@ -31,6 +126,10 @@ public:
 	std::string ParseStringZeroTerminated();
 	std::string ParseStringLengthPreceded();
 
+	// Zero-copy: views into the parsed buffer (or mapped file), so large blobs are never copied
+	std::span<byte_t const> ParseBytesView(size_t numBytes);
+	std::string_view ParseStringViewLengthPreceded();
+
 	Vec2    ParseVec2();
 	IntVec2 ParseIntVec2();
 	Rgba8   ParseRgba8();
@@ -38,19 +137,249 @@ public:
 
 	Vertex_PCU ParseVertexPCU();
 
+	// Fills every element with one bounds check and a memcpy, plus a vectorized byte swap if the buffer
+	// isn't in native order. T must have a BufferArrayElement layout (scalars, Vec2/3, IntVec2, Rgba8, Vertex_PCU).
+	template <typename T>
+	void ParseArray(std::span<T> outElements);
+	template <typename T>
+	void ParseArray(std::vector<T>& outElements, size_t count); // Resizes outElements to count first
+
 	void JumpToOffset(size_t absoluteOffset);
 	size_t GetOffset() const;
 	size_t GetSize() const;
-	EndianMode GetEndianMode() const { return m_mode; }
-
+	EndianMode GetEndianMode() const;
 
 
-private:
-	void ReadBytes(void* outData, size_t size);
 
 private:
-	const byte_t* m_data = nullptr;
-	size_t m_size = 0;
-	size_t m_offset = 0;
-	EndianMode m_mode;
+	std::variant<LittleEndianBufferParser, BigEndianBufferParser> m_parser;
 };
+
+
+//------------------------------------------------------------------------------------------------
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+void BasicBufferParser<endian, boundsCheck>::RequireBytes(size_t numBytes, char const* errorMessage) const
+{
+	if constexpr (IS_BOUNDS_CHECKED)
+	{
+		if (numBytes > m_size - m_offset)
+		{
+			throw std::runtime_error(errorMessage);
+		}
+	}
+	else
+	{
+		(void)numBytes;
+		(void)errorMessage;
+	}
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+template <typename T>
+T BasicBufferParser<endian, boundsCheck>::LoadValue(size_t offset) const
+{
+	T value;
+	memcpy(&value, m_data + offset, sizeof(T));
+	if constexpr (!IS_NATIVE_ORDER)
+	{
+		value = ByteSwapValue(value);
+	}
+	return value;
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+template <typename T>
+T BasicBufferParser<endian, boundsCheck>::ParseValue()
+{
+	RequireBytes(sizeof(T), "BufferParser read out of bounds");
+	T value = LoadValue<T>(m_offset);
+	m_offset += sizeof(T);
+	return value;
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+std::string BasicBufferParser<endian, boundsCheck>::ParseStringZeroTerminated()
+{
+	const char* start = reinterpret_cast<const char*>(m_data + m_offset);
+	size_t remaining = m_size - m_offset;
+	const void* terminator = (remaining > 0) ? memchr(start, '\0', remaining) : nullptr;
+	if (terminator == nullptr)
+	{
+		if constexpr (IS_BOUNDS_CHECKED)
+		{
+			throw std::runtime_error("String parse out of bounds");
+		}
+		m_offset = m_size;
+		return std::string(start, remaining);
+	}
+
+	size_t length = static_cast<size_t>(static_cast<const char*>(terminator) - start);
+	m_offset += length + 1;
+	return std::string(start, length);
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+std::string BasicBufferParser<endian, boundsCheck>::ParseStringLengthPreceded()
+{
+	uint32_t length = ParseUInt();
+	RequireBytes(length, "String length exceeds buffer");
+
+	std::string result(reinterpret_cast<const char*>(m_data + m_offset), length);
+	m_offset += length;
+	return result;
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+std::span<byte_t const> BasicBufferParser<endian, boundsCheck>::ParseBytesView(size_t numBytes)
+{
+	RequireBytes(numBytes, "BufferParser read out of bounds");
+	std::span<byte_t const> bytes(m_data + m_offset, numBytes);
+	m_offset += numBytes;
+	return bytes;
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+std::string_view BasicBufferParser<endian, boundsCheck>::ParseStringViewLengthPreceded()
+{
+	uint32_t length = ParseUInt();
+	RequireBytes(length, "String length exceeds buffer");
+
+	std::string_view result(reinterpret_cast<const char*>(m_data + m_offset), length);
+	m_offset += length;
+	return result;
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+Vec2 BasicBufferParser<endian, boundsCheck>::ParseVec2()
+{
+	RequireBytes(8, "BufferParser read out of bounds");
+	Vec2 v;
+	v.x = LoadValue<float>(m_offset);
+	v.y = LoadValue<float>(m_offset + 4);
+	m_offset += 8;
+	return v;
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+IntVec2 BasicBufferParser<endian, boundsCheck>::ParseIntVec2()
+{
+	RequireBytes(8, "BufferParser read out of bounds");
+	IntVec2 v;
+	v.x = LoadValue<int32_t>(m_offset);
+	v.y = LoadValue<int32_t>(m_offset + 4);
+	m_offset += 8;
+	return v;
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+Rgba8 BasicBufferParser<endian, boundsCheck>::ParseRgba8()
+{
+	RequireBytes(4, "BufferParser read out of bounds");
+	Rgba8 c;
+	c.r = m_data[m_offset + 0];
+	c.g = m_data[m_offset + 1];
+	c.b = m_data[m_offset + 2];
+	c.a = m_data[m_offset + 3];
+	m_offset += 4;
+	return c;
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+Rgba8 BasicBufferParser<endian, boundsCheck>::ParseRgb()
+{
+	RequireBytes(3, "BufferParser read out of bounds");
+	Rgba8 c;
+	c.r = m_data[m_offset + 0];
+	c.g = m_data[m_offset + 1];
+	c.b = m_data[m_offset + 2];
+	c.a = 255;
+	m_offset += 3;
+	return c;
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+Vertex_PCU BasicBufferParser<endian, boundsCheck>::ParseVertexPCU()
+{
+	RequireBytes(24, "BufferParser read out of bounds");
+	Vertex_PCU v;
+	v.m_position.x = LoadValue<float>(m_offset);
+	v.m_position.y = LoadValue<float>(m_offset + 4);
+	v.m_position.z = LoadValue<float>(m_offset + 8);
+	v.m_color.r = m_data[m_offset + 12];
+	v.m_color.g = m_data[m_offset + 13];
+	v.m_color.b = m_data[m_offset + 14];
+	v.m_color.a = m_data[m_offset + 15];
+	v.m_uvTexCoords.x = LoadValue<float>(m_offset + 16);
+	v.m_uvTexCoords.y = LoadValue<float>(m_offset + 20);
+	m_offset += 24;
+	return v;
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+template <typename T>
+void BasicBufferParser<endian, boundsCheck>::ParseArray(std::span<T> outElements)
+{
+	static_assert(BufferArrayElement<T>::IS_BULK_COPYABLE, "ParseArray needs a BufferArrayElement layout for this type");
+
+	size_t numBytes = outElements.size_bytes();
+	RequireBytes(numBytes, "BufferParser array read out of bounds");
+
+	if (numBytes > 0)
+	{
+		memcpy(static_cast<void*>(outElements.data()), m_data + m_offset, numBytes);
+	}
+	if constexpr (!IS_NATIVE_ORDER)
+	{
+		SwapBufferArrayElements<T>(outElements.data(), outElements.size());
+	}
+	m_offset += numBytes;
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+template <typename T>
+void BasicBufferParser<endian, boundsCheck>::ParseArray(std::vector<T>& outElements, size_t count)
+{
+	if constexpr (IS_BOUNDS_CHECKED)
+	{
+		// Fail before resizing, so a corrupt count can't trigger a huge allocation
+		if (count > (m_size - m_offset) / sizeof(T))
+		{
+			throw std::runtime_error("BufferParser array read out of bounds");
+		}
+	}
+	outElements.resize(count);
+	ParseArray(std::span<T>(outElements));
+}
+
+template <EndianMode endian, BufferBoundsCheck boundsCheck>
+void BasicBufferParser<endian, boundsCheck>::JumpToOffset(size_t absoluteOffset)
+{
+	if constexpr (IS_BOUNDS_CHECKED)
+	{
+		if (absoluteOffset > m_size)
+		{
+			throw std::runtime_error("JumpToOffset out of range");
+		}
+	}
+	m_offset = absoluteOffset;
+}
+
+
+//------------------------------------------------------------------------------------------------
+template <typename T>
+T BufferParser::ParseValue()
+{
+	return std::visit([](auto& parser) { return parser.template ParseValue<T>(); }, m_parser);
+}
+
+template <typename T>
+void BufferParser::ParseArray(std::span<T> outElements)
+{
+	std::visit([&](auto& parser) { parser.ParseArray(outElements); }, m_parser);
+}
+
+template <typename T>
+void BufferParser::ParseArray(std::vector<T>& outElements, size_t count)
+{
+	std::visit([&](auto& parser) { parser.ParseArray(outElements, count); }, m_parser);
+}
@@ -0,0 +1,331 @@
+#pragma once
+#include "Engine/Core/BufferParser.hpp"
+#include "Engine/Core/BufferWriter.hpp"
+#include <tuple>
+#include <type_traits>
+
+
+//------------------------------------------------------------------------------------------------
+// Declarative serialization: describe a struct's fields once and AppendSchema/ParseSchema generate both
+// directions, instead of hand-written Append/Parse pairs that must be kept in step.
+//
+//	template <>
+//	struct BufferSchema<Projectile>
+//	{
+//		static constexpr uint32_t VERSION = 1;
+//		static constexpr auto FIELDS = std::make_tuple(
+//			MakeBufferSchemaField(&Projectile::m_position),
+//			MakeBufferSchemaField(&Projectile::m_velocity),
+//			MakeBufferSchemaField(&Projectile::m_damage, 1)); // Added in version 1
+//	};
+//
+// Field types may be arithmetic types and enums, std::string (length preceded), anything with a
+// BufferArrayElement layout (Vec2, Vec3, IntVec2, Rgba8, Vertex_PCU), another type with a schema, or a
+// std::vector of any of those (a uint32 count, then the elements).
+//
+// When the struct is trivially copyable and a schema's fields are all bulk-copyable and cover it exactly, in
+// declaration order and with no padding, the struct (and every vector of it) is copied with a single memcpy
+// in native byte order.
+//
+// AppendSchemaVersioned also writes the version and payload size. ParseSchemaVersioned then leaves fields
+// newer than the data at their defaults, and skips trailing fields that this build doesn't know about.
+template <typename T>
+struct BufferSchema
+{
+};
+
+template <typename Owner, typename Field>
+struct BufferSchemaField
+{
+	typedef Field FieldType;
+
+	Field Owner::*	m_member;
+	uint32_t		m_sinceVersion = 0; // First schema version that has this field
+};
+
+template <typename Owner, typename Field>
+constexpr BufferSchemaField<Owner, Field> MakeBufferSchemaField(Field Owner::* member, uint32_t sinceVersion = 0)
+{
+	return BufferSchemaField<Owner, Field>{ member, sinceVersion };
+}
+
+template <typename T, typename Enable = void>
+struct HasBufferSchema : std::false_type {};
+
+template <typename T>
+struct HasBufferSchema<T, std::void_t<decltype(BufferSchema<T>::FIELDS)>> : std::true_type {};
+
+
+//------------------------------------------------------------------------------------------------
+// Writer is a BufferWriter or BasicBufferWriter, Parser a BufferParser or BasicBufferParser
+template <typename Writer, typename T>
+void AppendSchema(Writer& writer, T const& value);
+template <typename Parser, typename T>
+void ParseSchema(Parser& parser, T& outValue);
+
+template <typename Writer, typename T>
+void AppendSchemaVersioned(Writer& writer, T const& value); // uint32 version, uint32 payload size, then the fields
+template <typename Parser, typename T>
+void ParseSchemaVersioned(Parser& parser, T& outValue);
+
+template <typename Writer, typename T>
+void AppendSchemaValue(Writer& writer, T const& value); // One field value, by the rules above
+template <typename Parser, typename T>
+void ParseSchemaValue(Parser& parser, T& outValue);
+
+
+//------------------------------------------------------------------------------------------------
+// Byte offset of a member within a real object
+template <typename Owner, typename Field>
+size_t GetBufferSchemaFieldOffset(Owner const& owner, Field Owner::* member)
+{
+	return static_cast<size_t>(reinterpret_cast<unsigned char const*>(&(owner.*member)) - reinterpret_cast<unsigned char const*>(&owner));
+}
+
+template <typename T>
+bool ComputeIsBufferSchemaPacked()
+{
+	// memcpy is only defined for trivially copyable types; anything else (e.g. a struct holding Vec2s, which
+	// have user-provided copy operations) is serialized field by field
+	if constexpr (!std::is_trivially_copyable<T>::value || !std::is_default_constructible<T>::value)
+	{
+		return false;
+	}
+	else
+	{
+		T const instance{};
+		return std::apply([&instance](auto const&... fields)
+		{
+			size_t packedOffset = 0;
+			bool isPacked = true;
+			auto checkField = [&](auto const& field)
+			{
+				typedef typename std::decay_t<decltype(field)>::FieldType FieldType;
+				isPacked = isPacked && BufferArrayElement<FieldType>::IS_BULK_COPYABLE && !std::is_same<FieldType, bool>::value && GetBufferSchemaFieldOffset(instance, field.m_member) == packedOffset;
+				packedOffset += sizeof(FieldType);
+			};
+			(checkField(fields), ...);
+			return isPacked && packedOffset == sizeof(T);
+		}, BufferSchema<T>::FIELDS);
+	}
+}
+
+// True if T's serialized layout is exactly its memory layout
+template <typename T>
+bool IsBufferSchemaPacked()
+{
+	static bool const s_isPacked = ComputeIsBufferSchemaPacked<T>();
+	return s_isPacked;
+}
+
+template <typename T, typename Stream>
+bool CanBulkCopyBufferSchema(Stream const& stream)
+{
+	return IsNativeEndianMode(stream.GetEndianMode()) && IsBufferSchemaPacked<T>();
+}
+
+template <typename T>
+struct IsBufferSchemaVector : std::false_type {};
+
+template <typename T, typename Allocator>
+struct IsBufferSchemaVector<std::vector<T, Allocator>> : std::true_type {};
+
+
+//------------------------------------------------------------------------------------------------
+template <typename Writer, typename T>
+void AppendSchema(Writer& writer, T const& value)
+{
+	static_assert(HasBufferSchema<T>::value, "AppendSchema needs a BufferSchema specialization for this type");
+
+	if (CanBulkCopyBufferSchema<T>(writer))
+	{
+		writer.AppendArray(std::span<byte_t const>(reinterpret_cast<byte_t const*>(&value), sizeof(T)));
+		return;
+	}
+	std::apply([&](auto const&... fields) { (AppendSchemaValue(writer, value.*(fields.m_member)), ...); }, BufferSchema<T>::FIELDS);
+}
+
+template <typename Parser, typename T>
+void ParseSchema(Parser& parser, T& outValue)
+{
+	static_assert(HasBufferSchema<T>::value, "ParseSchema needs a BufferSchema specialization for this type");
+
+	if (CanBulkCopyBufferSchema<T>(parser))
+	{
+		parser.ParseArray(std::span<byte_t>(reinterpret_cast<byte_t*>(&outValue), sizeof(T)));
+		return;
+	}
+	std::apply([&](auto const&... fields) { (ParseSchemaValue(parser, outValue.*(fields.m_member)), ...); }, BufferSchema<T>::FIELDS);
+}
+
+template <typename Writer, typename T>
+void AppendSchemaVersioned(Writer& writer, T const& value)
+{
+	writer.AppendUInt(BufferSchema<T>::VERSION);
+	size_t sizeOffset = writer.GetSize();
+	writer.AppendUInt(0);
+
+	size_t payloadStart = writer.GetSize();
+	AppendSchema(writer, value);
+	writer.OverwriteUInt32At(sizeOffset, static_cast<uint32_t>(writer.GetSize() - payloadStart));
+}
+
+template <typename Parser, typename T>
+void ParseSchemaVersioned(Parser& parser, T& outValue)
+{
+	uint32_t version = parser.ParseUInt();
+	uint32_t payloadSize = parser.ParseUInt();
+	size_t payloadEnd = parser.GetOffset() + payloadSize;
+	if (payloadEnd > parser.GetSize())
+	{
+		throw std::runtime_error("Schema payload exceeds buffer");
+	}
+
+	if (version == BufferSchema<T>::VERSION)
+	{
+		ParseSchema(parser, outValue);
+	}
+	else
+	{
+		std::apply([&](auto const&... fields)
+		{
+			auto parseField = [&](auto const& field)
+			{
+				if (field.m_sinceVersion <= version)
+				{
+					ParseSchemaValue(parser, outValue.*(field.m_member));
+				}
+			};
+			(parseField(fields), ...);
+		}, BufferSchema<T>::FIELDS);
+	}
+
+	if (parser.GetOffset() > payloadEnd)
+	{
+		throw std::runtime_error("Schema fields overran their payload");
+	}
+	parser.JumpToOffset(payloadEnd);
+}
+
+template <typename Writer, typename T>
+void AppendSchemaValue(Writer& writer, T const& value)
+{
+	if constexpr (std::is_same<T, bool>::value)
+	{
+		writer.AppendByte(value ? 1 : 0);
+	}
+	else if constexpr (std::is_enum<T>::value)
+	{
+		writer.AppendValue(static_cast<std::underlying_type_t<T>>(value));
+	}
+	else if constexpr (std::is_arithmetic<T>::value)
+	{
+		writer.AppendValue(value);
+	}
+	else if constexpr (std::is_same<T, std::string>::value)
+	{
+		writer.AppendStringLengthPreceded(value);
+	}
+	else if constexpr (BufferArrayElement<T>::IS_BULK_COPYABLE)
+	{
+		writer.AppendArray(std::span<T const>(&value, 1));
+	}
+	else if constexpr (IsBufferSchemaVector<T>::value)
+	{
+		typedef typename T::value_type Element;
+		static_assert(!std::is_same<Element, bool>::value, "Serialize a std::vector<uint8_t> instead of std::vector<bool>");
+		writer.AppendUInt(static_cast<uint32_t>(value.size()));
+		if constexpr (BufferArrayElement<Element>::IS_BULK_COPYABLE)
+		{
+			writer.AppendArray(std::span<Element const>(value));
+		}
+		else if constexpr (HasBufferSchema<Element>::value)
+		{
+			if (CanBulkCopyBufferSchema<Element>(writer))
+			{
+				writer.AppendArray(std::span<byte_t const>(reinterpret_cast<byte_t const*>(value.data()), value.size() * sizeof(Element)));
+				return;
+			}
+			for (Element const& element : value)
+			{
+				AppendSchema(writer, element);
+			}
+		}
+		else
+		{
+			for (Element const& element : value)
+			{
+				AppendSchemaValue(writer, element);
+			}
+		}
+	}
+	else
+	{
+		AppendSchema(writer, value);
+	}
+}
+
+template <typename Parser, typename T>
+void ParseSchemaValue(Parser& parser, T& outValue)
+{
+	if constexpr (std::is_same<T, bool>::value)
+	{
+		outValue = parser.ParseBool();
+	}
+	else if constexpr (std::is_enum<T>::value)
+	{
+		outValue = static_cast<T>(parser.template ParseValue<std::underlying_type_t<T>>());
+	}
+	else if constexpr (std::is_arithmetic<T>::value)
+	{
+		outValue = parser.template ParseValue<T>();
+	}
+	else if constexpr (std::is_same<T, std::string>::value)
+	{
+		outValue = parser.ParseStringLengthPreceded();
+	}
+	else if constexpr (BufferArrayElement<T>::IS_BULK_COPYABLE)
+	{
+		parser.ParseArray(std::span<T>(&outValue, 1));
+	}
+	else if constexpr (IsBufferSchemaVector<T>::value)
+	{
+		typedef typename T::value_type Element;
+		static_assert(!std::is_same<Element, bool>::value, "Serialize a std::vector<uint8_t> instead of std::vector<bool>");
+		uint32_t count = parser.ParseUInt();
+		if (count > parser.GetSize() - parser.GetOffset())
+		{
+			throw std::runtime_error("Schema vector count exceeds buffer"); // Every element takes at least a byte
+		}
+
+		if constexpr (BufferArrayElement<Element>::IS_BULK_COPYABLE)
+		{
+			parser.ParseArray(outValue, count);
+		}
+		else if constexpr (HasBufferSchema<Element>::value)
+		{
+			outValue.resize(count);
+			if (CanBulkCopyBufferSchema<Element>(parser))
+			{
+				parser.ParseArray(std::span<byte_t>(reinterpret_cast<byte_t*>(outValue.data()), outValue.size() * sizeof(Element)));
+				return;
+			}
+			for (Element& element : outValue)
+			{
+				ParseSchema(parser, element);
+			}
+		}
+		else
+		{
+			outValue.resize(count);
+			for (Element& element : outValue)
+			{
+				ParseSchemaValue(parser, element);
+			}
+		}
+	}
+	else
+	{
+		ParseSchema(parser, outValue);
+	}
+}
@@ -1,9 +1,19 @@
 #pragma once
 #include <vector>
+#include <bit>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
+#include <type_traits>
 #include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/IntVec2.hpp"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BUFFER_UTILS_SSE2
+#endif
 
 extern DevConsole* g_theDevConsole;
 
@@ -16,10 +26,84 @@ enum class EndianMode
 	BIG
 };
 
-inline bool IsMachineLittleEndian()
+constexpr bool IsMachineLittleEndian()
+{
+	return std::endian::native == std::endian::little;
+}
+
+// NATIVE becomes the machine's order; LITTLE and BIG pass through
+constexpr EndianMode ResolveEndianMode(EndianMode mode)
+{
+	if (mode == EndianMode::NATIVE)
+	{
+		return IsMachineLittleEndian() ? EndianMode::LITTLE : EndianMode::BIG;
+	}
+	return mode;
+}
+
+constexpr bool IsNativeEndianMode(EndianMode mode)
+{
+	return ResolveEndianMode(mode) == ResolveEndianMode(EndianMode::NATIVE);
+}
+
+// Reverses the bytes of one scalar; written as shifts so compilers emit a single bswap
+template <typename T>
+T ByteSwapValue(T value)
+{
+	static_assert(std::is_arithmetic<T>::value && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8), "ByteSwapValue takes 1, 2, 4 or 8 byte scalars");
+	if constexpr (sizeof(T) == 1)
+	{
+		return value;
+	}
+	else if constexpr (sizeof(T) == 2)
+	{
+		uint16_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		bits = static_cast<uint16_t>((bits >> 8) | (bits << 8));
+		memcpy(&value, &bits, sizeof(bits));
+		return value;
+	}
+	else if constexpr (sizeof(T) == 4)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		bits = ((bits & 0x000000FFu) << 24) | ((bits & 0x0000FF00u) << 8) | ((bits & 0x00FF0000u) >> 8) | ((bits & 0xFF000000u) >> 24);
+		memcpy(&value, &bits, sizeof(bits));
+		return value;
+	}
+	else
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		uint32_t low = static_cast<uint32_t>(bits);
+		uint32_t high = static_cast<uint32_t>(bits >> 32);
+		bits = (static_cast<uint64_t>(ByteSwapValue(low)) << 32) | ByteSwapValue(high);
+		memcpy(&value, &bits, sizeof(bits));
+		return value;
+	}
+}
+
+// Maps signed values onto unsigned ones by magnitude (0, -1, 1, -2... -> 0, 1, 2, 3...), so small negative
+// numbers stay small when written as varints
+constexpr uint64_t ZigZagEncode(int64_t value)
+{
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+constexpr int64_t ZigZagDecode(uint64_t value)
+{
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Bits needed to store any of numValues distinct values (0 or 1 values need none)
+constexpr int GetNumBitsForValueCount(uint64_t numValues)
 {
-	uint16_t v = 0x1;
-	return *((byte_t*)&v) == 0x1;
+	int numBits = 0;
+	while (numBits < 64 && (numValues - 1) >> numBits != 0)
+	{
+		++numBits;
+	}
+	return (numValues <= 1) ? 0 : numBits;
 }
 
 inline void PrintBufferHexOnDevConsole(const std::vector<byte_t>& buffer)
@@ -35,4 +119,102 @@ inline void PrintBufferHexOnDevConsole(const std::vector<byte_t>& buffer)
 }
 
 
+//------------------------------------------------------------------------------------------------
+// Reverses every wordBytes-wide word (2, 4 or 8) in place; used when a buffer's byte order isn't native.
+// SSE2 handles 16 bytes per step, the scalar loop takes the tail.
+inline void SwapBufferWords(void* data, size_t numBytes, size_t wordBytes)
+{
+	if (wordBytes < 2)
+	{
+		return;
+	}
+
+	byte_t* bytes = static_cast<byte_t*>(data);
+	size_t offset = 0;
+#if defined(BUFFER_UTILS_SSE2)
+	for (; offset + 16 <= numBytes; offset += 16)
+	{
+		__m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes + offset));
+		block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8)); // Swap bytes within 16-bit halves
+		if (wordBytes >= 4)
+		{
+			block = _mm_shufflelo_epi16(_mm_shufflehi_epi16(block, 0xB1), 0xB1); // Swap halves within 32-bit words
+		}
+		if (wordBytes == 8)
+		{
+			block = _mm_shuffle_epi32(block, 0xB1); // Swap words within 64-bit words
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + offset), block);
+	}
+#endif
+	for (; offset + wordBytes <= numBytes; offset += wordBytes)
+	{
+		for (size_t i = 0; i < wordBytes / 2; ++i)
+		{
+			byte_t temp = bytes[offset + i];
+			bytes[offset + i] = bytes[offset + wordBytes - 1 - i];
+			bytes[offset + wordBytes - 1 - i] = temp;
+		}
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+// Element types that ParseArray/AppendArray may copy in bulk: their serialized layout is exactly their
+// memory layout, a packed run of WORD_BYTES-wide words. When the byte order isn't native every word is
+// reversed, except those flagged in UNSWAPPED_WORDS_MASK (bit i = word i of the element, e.g. a color).
+template <typename T, typename Enable = void>
+struct BufferArrayElement
+{
+	static constexpr bool IS_BULK_COPYABLE = false;
+};
 
+template <typename T>
+struct BufferArrayElement<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+{
+	static constexpr bool IS_BULK_COPYABLE = true;
+	static constexpr size_t WORD_BYTES = sizeof(T);
+	static constexpr uint32_t UNSWAPPED_WORDS_MASK = 0;
+};
+
+template <size_t wordBytes, uint32_t unswappedWordsMask = 0>
+struct BufferArrayWords
+{
+	static constexpr bool IS_BULK_COPYABLE = true;
+	static constexpr size_t WORD_BYTES = wordBytes;
+	static constexpr uint32_t UNSWAPPED_WORDS_MASK = unswappedWordsMask;
+};
+
+static_assert(sizeof(Vec2) == 8 && sizeof(Vec3) == 12 && sizeof(IntVec2) == 8 && sizeof(Rgba8) == 4, "Engine math types must stay tightly packed to be bulk serialized");
+static_assert(sizeof(Vertex_PCU) == 24, "Vertex_PCU must stay tightly packed to be bulk serialized");
+
+template <> struct BufferArrayElement<Vec2> : BufferArrayWords<4> {};
+template <> struct BufferArrayElement<Vec3> : BufferArrayWords<4> {};
+template <> struct BufferArrayElement<IntVec2> : BufferArrayWords<4> {};
+template <> struct BufferArrayElement<Rgba8> : BufferArrayWords<1> {};
+template <> struct BufferArrayElement<Vertex_PCU> : BufferArrayWords<4, 1u << 3> {}; // Position xyz, color bytes, uv
+
+// Converts count packed elements between native and swapped byte order (the operation is its own inverse)
+template <typename T>
+void SwapBufferArrayElements(void* elements, size_t count)
+{
+	typedef BufferArrayElement<T> Layout;
+	if (Layout::WORD_BYTES > 1)
+	{
+		SwapBufferWords(elements, count * sizeof(T), Layout::WORD_BYTES);
+	}
+	if (Layout::UNSWAPPED_WORDS_MASK != 0)
+	{
+		byte_t* bytes = static_cast<byte_t*>(elements);
+		for (size_t elementIndex = 0; elementIndex < count; ++elementIndex)
+		{
+			for (size_t wordIndex = 0; wordIndex < sizeof(T) / Layout::WORD_BYTES; ++wordIndex)
+			{
+				if (Layout::UNSWAPPED_WORDS_MASK & (1u << wordIndex))
+				{
+					SwapBufferWords(bytes + (elementIndex * sizeof(T)) + (wordIndex * Layout::WORD_BYTES), Layout::WORD_BYTES, Layout::WORD_BYTES);
+				}
+			}
+		}
+	}
+}
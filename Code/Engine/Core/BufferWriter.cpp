@@ -1,154 +1,62 @@
 #include "Engine/Core/BufferWriter.hpp"
-#include "Engine/Math/Vec2.hpp"
-#include "Engine/Math/IntVec2.hpp"
-#include "Engine/Core/Rgba8.hpp"
-#include "Engine/Core/Vertex_PCU.hpp"
-#include <iostream>
-#include <iomanip>
-
-static void CopyBytesReversed(byte_t* dst, const byte_t* src, size_t size)
-{
-	for (size_t i = 0; i < size; ++i)
-	{
-		dst[i] = src[size - 1 - i];
-	}
-}
 
 BufferWriter::BufferWriter(std::vector<byte_t>& buffer, EndianMode mode)
-	: m_buffer(buffer)
+	: m_writer(LittleEndianBufferWriter(buffer))
 {
-	if (mode == EndianMode::NATIVE)
-	{
-		m_mode = IsMachineLittleEndian() ? EndianMode::LITTLE : EndianMode::BIG;
-	}
-	else
-	{
-		m_mode = mode;
-	}
+	SetEndianMode(mode);
 }
 
 void BufferWriter::SetEndianMode(EndianMode mode)
 {
-	if (mode == EndianMode::NATIVE)
-	{
-		m_mode = IsMachineLittleEndian() ? EndianMode::LITTLE : EndianMode::BIG;
-	}
-	else
-	{
-		m_mode = mode;
-	}
-}
-
-void BufferWriter::AppendBytes(const void* data, size_t size)
-{
-	const byte_t* src = (const byte_t*)data;
-
-	bool machineLittle = IsMachineLittleEndian();
-	bool wantLittle = (m_mode == EndianMode::LITTLE);
-
-	if (machineLittle == wantLittle)
+	std::vector<byte_t>& buffer = std::visit([](auto const& writer) -> std::vector<byte_t>& { return writer.GetBuffer(); }, m_writer);
+	if (ResolveEndianMode(mode) == EndianMode::BIG)
 	{
-		m_buffer.insert(m_buffer.end(), src, src + size);
+		m_writer = BigEndianBufferWriter(buffer);
 	}
 	else
 	{
-		size_t oldSize = m_buffer.size();
-		m_buffer.resize(oldSize + size);
-
-		CopyBytesReversed(&m_buffer[oldSize], src, size);
+		m_writer = LittleEndianBufferWriter(buffer);
 	}
 }
 
-void BufferWriter::AppendByte(byte_t value) { AppendBytes(&value, sizeof(value)); }
-void BufferWriter::AppendChar(char value) { AppendBytes(&value, sizeof(value)); }
-void BufferWriter::AppendUShort(uint16_t v) { AppendBytes(&v, sizeof(v)); }
-void BufferWriter::AppendShort(int16_t v) { AppendBytes(&v, sizeof(v)); }
-void BufferWriter::AppendUInt(uint32_t v) { AppendBytes(&v, sizeof(v)); }
-void BufferWriter::AppendInt(int32_t v) { AppendBytes(&v, sizeof(v)); }
-void BufferWriter::AppendUInt64(uint64_t v) { AppendBytes(&v, sizeof(v)); }
-void BufferWriter::AppendInt64(int64_t v) { AppendBytes(&v, sizeof(v)); }
-void BufferWriter::AppendFloat(float v) { AppendBytes(&v, sizeof(v)); }
-void BufferWriter::AppendDouble(double v) { AppendBytes(&v, sizeof(v)); }
+void BufferWriter::AppendByte(byte_t value) { std::visit([value](auto& writer) { writer.AppendByte(value); }, m_writer); }
+void BufferWriter::AppendChar(char value) { std::visit([value](auto& writer) { writer.AppendChar(value); }, m_writer); }
+void BufferWriter::AppendUShort(uint16_t v) { std::visit([v](auto& writer) { writer.AppendUShort(v); }, m_writer); }
+void BufferWriter::AppendShort(int16_t v) { std::visit([v](auto& writer) { writer.AppendShort(v); }, m_writer); }
+void BufferWriter::AppendUInt(uint32_t v) { std::visit([v](auto& writer) { writer.AppendUInt(v); }, m_writer); }
+void BufferWriter::AppendInt(int32_t v) { std::visit([v](auto& writer) { writer.AppendInt(v); }, m_writer); }
+void BufferWriter::AppendUInt64(uint64_t v) { std::visit([v](auto& writer) { writer.AppendUInt64(v); }, m_writer); }
+void BufferWriter::AppendInt64(int64_t v) { std::visit([v](auto& writer) { writer.AppendInt64(v); }, m_writer); }
+void BufferWriter::AppendFloat(float v) { std::visit([v](auto& writer) { writer.AppendFloat(v); }, m_writer); }
+void BufferWriter::AppendDouble(double v) { std::visit([v](auto& writer) { writer.AppendDouble(v); }, m_writer); }
 
-void BufferWriter::AppendRgba8(const Rgba8& c)
-{
-	AppendByte((byte_t)c.r);
-	AppendByte((byte_t)c.g);
-	AppendByte((byte_t)c.b);
-	AppendByte((byte_t)c.a);
-}
+void BufferWriter::AppendRgba8(const Rgba8& c) { std::visit([&c](auto& writer) { writer.AppendRgba8(c); }, m_writer); }
+void BufferWriter::AppendVec2(const Vec2& v) { std::visit([&v](auto& writer) { writer.AppendVec2(v); }, m_writer); }
+void BufferWriter::AppendIntVec2(const IntVec2& v) { std::visit([&v](auto& writer) { writer.AppendIntVec2(v); }, m_writer); }
+void BufferWriter::AppendVertexPCU(const Vertex_PCU& v) { std::visit([&v](auto& writer) { writer.AppendVertexPCU(v); }, m_writer); }
 
-void BufferWriter::AppendVec2(const Vec2& v)
-{
-	AppendFloat(v.x);
-	AppendFloat(v.y);
-}
 
-void BufferWriter::AppendIntVec2(const IntVec2& v)
+void BufferWriter::OverwriteUInt32At(size_t offset, uint32_t value)
 {
-    AppendInt(v.x);
-    AppendInt(v.y);
+	std::visit([offset, value](auto& writer) { writer.OverwriteUInt32At(offset, value); }, m_writer);
 }
 
-void BufferWriter::AppendVertexPCU(const Vertex_PCU& v)
+void BufferWriter::AppendStringZeroTerminated(const std::string& s)
 {
-	AppendFloat(v.m_position.x);
-	AppendFloat(v.m_position.y);
-	AppendFloat(v.m_position.z);
-
-	AppendRgba8(v.m_color);
-
-	AppendFloat(v.m_uvTexCoords.x);
-	AppendFloat(v.m_uvTexCoords.y);
+	std::visit([&s](auto& writer) { writer.AppendStringZeroTerminated(s); }, m_writer);
 }
 
-
-void BufferWriter::OverwriteUInt32At(size_t offset, uint32_t value)
+void BufferWriter::AppendStringLengthPreceded(const std::string& s)
 {
-	if (offset + sizeof(uint32_t) > m_buffer.size())
-	{
-		ERROR_AND_DIE("OverwriteUInt32At out of range");
-	}
-
-	byte_t temp[4];
-	const byte_t* src = (const byte_t*)&value;
-
-	bool machineLittle = IsMachineLittleEndian();
-	bool wantLittle = (m_mode == EndianMode::LITTLE);
-
-	if (machineLittle == wantLittle)
-	{
-		temp[0] = src[0]; temp[1] = src[1]; temp[2] = src[2]; temp[3] = src[3];
-	}
-	else
-	{
-		temp[0] = src[3]; temp[1] = src[2]; temp[2] = src[1]; temp[3] = src[0];
-	}
-
-	m_buffer[offset + 0] = temp[0];
-	m_buffer[offset + 1] = temp[1];
-	m_buffer[offset + 2] = temp[2];
-	m_buffer[offset + 3] = temp[3];
+	std::visit([&s](auto& writer) { writer.AppendStringLengthPreceded(s); }, m_writer);
 }
 
-void BufferWriter::AppendStringZeroTerminated(const std::string& s)
+EndianMode BufferWriter::GetEndianMode() const
 {
-	if (!s.empty())
-	{
-		m_buffer.insert(m_buffer.end(), (const byte_t*)s.data(), (const byte_t*)s.data() + s.size());
-	}
-	byte_t zero = 0;
-	AppendByte(zero);
+	return std::holds_alternative<BigEndianBufferWriter>(m_writer) ? EndianMode::BIG : EndianMode::LITTLE;
 }
 
-void BufferWriter::AppendStringLengthPreceded(const std::string& s)
+size_t BufferWriter::GetSize() const
 {
-	AppendUInt((uint32_t)s.size());
-
-	if (!s.empty())
-	{
-		m_buffer.insert(m_buffer.end(), (const byte_t*)s.data(), (const byte_t*)s.data() + s.size());
-	}
+	return std::visit([](auto const& writer) { return writer.GetSize(); }, m_writer);
 }
-
-
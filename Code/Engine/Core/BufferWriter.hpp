@@ -1,12 +1,74 @@
 #pragma once
+#include <span>
 #include <string>
+#include <variant>
 #include "Engine/Core/BufferUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/IntVec2.hpp"
 
-struct Rgba8;
-struct Vec2;
-struct IntVec2;
-struct Vertex_PCU;
 
+//------------------------------------------------------------------------------------------------
+// Byte order fixed at compile time; the writing counterpart of BasicBufferParser. Each append grows the
+// buffer once and stores straight into it, byte swapping only when the order isn't native.
+template <EndianMode endian>
+class BasicBufferWriter
+{
+public:
+	static constexpr EndianMode ENDIAN_MODE = ResolveEndianMode(endian);
+	static constexpr bool IS_NATIVE_ORDER = IsNativeEndianMode(endian);
+
+	explicit BasicBufferWriter(std::vector<byte_t>& buffer) : m_buffer(&buffer) {}
+
+	constexpr EndianMode GetEndianMode() const { return ENDIAN_MODE; }
+
+	template <typename T>
+	void AppendValue(T value); // Any arithmetic type
+
+	void AppendByte(byte_t value) { AppendValue(value); }
+	void AppendChar(char value) { AppendValue(value); }
+	void AppendUShort(uint16_t value) { AppendValue(value); }
+	void AppendShort(int16_t value) { AppendValue(value); }
+	void AppendUInt(uint32_t value) { AppendValue(value); }
+	void AppendInt(int32_t value) { AppendValue(value); }
+	void AppendUInt64(uint64_t value) { AppendValue(value); }
+	void AppendInt64(int64_t value) { AppendValue(value); }
+	void AppendFloat(float value) { AppendValue(value); }
+	void AppendDouble(double value) { AppendValue(value); }
+	void AppendRgba8(const Rgba8& c);
+	void AppendVec2(const Vec2& v);
+	void AppendIntVec2(const IntVec2& v);
+	void AppendVertexPCU(const Vertex_PCU& v);
+
+	template <typename T>
+	void AppendArray(std::span<T const> elements);
+	template <typename T>
+	void AppendArray(std::vector<T> const& elements) { AppendArray(std::span<T const>(elements)); }
+	void OverwriteUInt32At(size_t offset, uint32_t value);
+
+	void AppendStringZeroTerminated(const std::string& s);
+	void AppendStringLengthPreceded(const std::string& s);
+
+	std::vector<byte_t>& GetBuffer() const { return *m_buffer; }
+	size_t GetSize() const { return m_buffer->size(); } // Offset of the next appended byte
+
+private:
+	byte_t* Grow(size_t numBytes); // Returns where the new bytes start
+	template <typename T>
+	static void StoreValue(byte_t* destination, T value);
+
+private:
+	std::vector<byte_t>* m_buffer = nullptr; // A pointer so writers stay assignable
+};
+
+typedef BasicBufferWriter<EndianMode::LITTLE>	LittleEndianBufferWriter;
+typedef BasicBufferWriter<EndianMode::BIG>		BigEndianBufferWriter;
+
+
+//------------------------------------------------------------------------------------------------
+// Byte order chosen at runtime; forwards each call to the matching BasicBufferWriter
 class BufferWriter
 {
 public:
@@ -15,6 +77,9 @@ public:
 public:
 	void SetEndianMode(EndianMode mode);
 
+	template <typename T>
+	void AppendValue(T value); // Any arithmetic type
+
 	void AppendByte(byte_t value);
 	void AppendChar(char value);
 	void AppendUShort(uint16_t value);
@@ -29,16 +94,152 @@ public:
 	void AppendVec2(const Vec2& v);
 	void AppendIntVec2(const IntVec2& v);
 	void AppendVertexPCU(const Vertex_PCU& v);
+
+	// Appends every element with one resize and a memcpy, plus a vectorized byte swap if the buffer
+	// isn't in native order. T must have a BufferArrayElement layout (scalars, Vec2/3, IntVec2, Rgba8, Vertex_PCU).
+	template <typename T>
+	void AppendArray(std::span<T const> elements);
+	template <typename T>
+	void AppendArray(std::vector<T> const& elements) { AppendArray(std::span<T const>(elements)); }
 	void OverwriteUInt32At(size_t offset, uint32_t value);
 
 
 	void AppendStringZeroTerminated(const std::string& s);
 	void AppendStringLengthPreceded(const std::string& s);
 
-private:
-	void AppendBytes(const void* data, size_t size);
+	EndianMode GetEndianMode() const;
+	size_t GetSize() const; // Offset of the next appended byte
 
 private:
-	std::vector<byte_t>& m_buffer;
-	EndianMode m_mode;
+	std::variant<LittleEndianBufferWriter, BigEndianBufferWriter> m_writer;
 };
+
+
+//------------------------------------------------------------------------------------------------
+template <EndianMode endian>
+byte_t* BasicBufferWriter<endian>::Grow(size_t numBytes)
+{
+	size_t oldSize = m_buffer->size();
+	m_buffer->resize(oldSize + numBytes);
+	return m_buffer->data() + oldSize;
+}
+
+template <EndianMode endian>
+template <typename T>
+void BasicBufferWriter<endian>::StoreValue(byte_t* destination, T value)
+{
+	if constexpr (!IS_NATIVE_ORDER)
+	{
+		value = ByteSwapValue(value);
+	}
+	memcpy(destination, &value, sizeof(T));
+}
+
+template <EndianMode endian>
+template <typename T>
+void BasicBufferWriter<endian>::AppendValue(T value)
+{
+	StoreValue(Grow(sizeof(T)), value);
+}
+
+template <EndianMode endian>
+void BasicBufferWriter<endian>::AppendRgba8(const Rgba8& c)
+{
+	byte_t* destination = Grow(4);
+	destination[0] = c.r;
+	destination[1] = c.g;
+	destination[2] = c.b;
+	destination[3] = c.a;
+}
+
+template <EndianMode endian>
+void BasicBufferWriter<endian>::AppendVec2(const Vec2& v)
+{
+	byte_t* destination = Grow(8);
+	StoreValue(destination, v.x);
+	StoreValue(destination + 4, v.y);
+}
+
+template <EndianMode endian>
+void BasicBufferWriter<endian>::AppendIntVec2(const IntVec2& v)
+{
+	byte_t* destination = Grow(8);
+	StoreValue<int32_t>(destination, v.x);
+	StoreValue<int32_t>(destination + 4, v.y);
+}
+
+template <EndianMode endian>
+void BasicBufferWriter<endian>::AppendVertexPCU(const Vertex_PCU& v)
+{
+	byte_t* destination = Grow(24);
+	StoreValue(destination, v.m_position.x);
+	StoreValue(destination + 4, v.m_position.y);
+	StoreValue(destination + 8, v.m_position.z);
+	destination[12] = v.m_color.r;
+	destination[13] = v.m_color.g;
+	destination[14] = v.m_color.b;
+	destination[15] = v.m_color.a;
+	StoreValue(destination + 16, v.m_uvTexCoords.x);
+	StoreValue(destination + 20, v.m_uvTexCoords.y);
+}
+
+template <EndianMode endian>
+template <typename T>
+void BasicBufferWriter<endian>::AppendArray(std::span<T const> elements)
+{
+	static_assert(BufferArrayElement<T>::IS_BULK_COPYABLE, "AppendArray needs a BufferArrayElement layout for this type");
+
+	byte_t* destination = Grow(elements.size_bytes());
+	if (elements.empty())
+	{
+		return;
+	}
+
+	memcpy(destination, static_cast<void const*>(elements.data()), elements.size_bytes());
+	if constexpr (!IS_NATIVE_ORDER)
+	{
+		SwapBufferArrayElements<T>(destination, elements.size());
+	}
+}
+
+template <EndianMode endian>
+void BasicBufferWriter<endian>::OverwriteUInt32At(size_t offset, uint32_t value)
+{
+	if (offset + sizeof(uint32_t) > m_buffer->size())
+	{
+		ERROR_AND_DIE("OverwriteUInt32At out of range");
+	}
+	StoreValue(m_buffer->data() + offset, value);
+}
+
+template <EndianMode endian>
+void BasicBufferWriter<endian>::AppendStringZeroTerminated(const std::string& s)
+{
+	byte_t* destination = Grow(s.size() + 1);
+	memcpy(destination, s.c_str(), s.size() + 1);
+}
+
+template <EndianMode endian>
+void BasicBufferWriter<endian>::AppendStringLengthPreceded(const std::string& s)
+{
+	byte_t* destination = Grow(sizeof(uint32_t) + s.size());
+	StoreValue(destination, static_cast<uint32_t>(s.size()));
+	if (!s.empty())
+	{
+		memcpy(destination + sizeof(uint32_t), s.data(), s.size());
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+template <typename T>
+void BufferWriter::AppendValue(T value)
+{
+	std::visit([value](auto& writer) { writer.AppendValue(value); }, m_writer);
+}
+
+template <typename T>
+void BufferWriter::AppendArray(std::span<T const> elements)
+{
+	std::visit([&](auto& writer) { writer.AppendArray(elements); }, m_writer);
+}
@@ -0,0 +1,153 @@
+#include "Engine/Core/DefinitionCache.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/MappedFile.hpp"
+#include <filesystem>
+#include <stdexcept>
+
+
+//------------------------------------------------------------------------------------------------
+// Layout (little-endian): magic, cache format, definition version, source size, source write time,
+// source hash, payload size, payload
+constexpr uint32_t DEFINITION_CACHE_MAGIC = 0x46454447; // "GDEF"
+constexpr uint32_t DEFINITION_CACHE_FORMAT = 1;
+constexpr size_t DEFINITION_CACHE_WRITE_TIME_OFFSET = 20;
+constexpr size_t DEFINITION_CACHE_HEADER_SIZE = 40;
+
+
+//------------------------------------------------------------------------------------------------
+struct DefinitionSourceStamp
+{
+	uint64_t	m_size = 0;
+	int64_t		m_writeTime = 0;
+};
+
+static bool GetDefinitionSourceStamp(std::string const& sourcePath, DefinitionSourceStamp& outStamp)
+{
+	std::error_code error;
+	uintmax_t size = std::filesystem::file_size(sourcePath, error);
+	if (error)
+	{
+		return false;
+	}
+	std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(sourcePath, error);
+	if (error)
+	{
+		return false;
+	}
+
+	outStamp.m_size = static_cast<uint64_t>(size);
+	outStamp.m_writeTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+	return true;
+}
+
+static uint64_t HashDefinitionSource(std::span<unsigned char const> source)
+{
+	uint64_t hash = 14695981039346656037ull; // FNV-1a
+	for (uint8_t sourceByte : source)
+	{
+		hash ^= sourceByte;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+
+//------------------------------------------------------------------------------------------------
+std::string GetDefinitionCachePath(std::string const& sourcePath)
+{
+	return sourcePath + ".bin";
+}
+
+
+//------------------------------------------------------------------------------------------------
+bool LoadDefinitionCache(std::string const& sourcePath, uint32_t definitionVersion, std::function<void(BufferParser& parser)> const& readDefinitions)
+{
+	DefinitionSourceStamp stamp;
+	if (!GetDefinitionSourceStamp(sourcePath, stamp))
+	{
+		return false;
+	}
+
+	// Parsed straight out of the mapping, so the payload is never copied into a heap buffer
+	std::string cachePath = GetDefinitionCachePath(sourcePath);
+	MappedFile cache;
+	if (!cache.Open(cachePath) || cache.GetSize() < DEFINITION_CACHE_HEADER_SIZE)
+	{
+		return false;
+	}
+
+	try
+	{
+		BufferParser parser(cache, EndianMode::LITTLE);
+		if (parser.ParseUInt() != DEFINITION_CACHE_MAGIC || parser.ParseUInt() != DEFINITION_CACHE_FORMAT || parser.ParseUInt() != definitionVersion)
+		{
+			return false;
+		}
+		uint64_t sourceSize = parser.ParseUInt64();
+		int64_t sourceWriteTime = parser.ParseInt64();
+		uint64_t sourceHash = parser.ParseUInt64();
+		uint32_t payloadSize = parser.ParseUInt();
+		if (sourceSize != stamp.m_size || DEFINITION_CACHE_HEADER_SIZE + payloadSize != cache.GetSize())
+		{
+			return false;
+		}
+
+		if (sourceWriteTime != stamp.m_writeTime)
+		{
+			// Touched but maybe not edited; only the hash can tell. Refresh the stored time if it still matches.
+			MappedFile source;
+			if (!source.Open(sourcePath) || HashDefinitionSource(source.GetBytes()) != sourceHash)
+			{
+				return false;
+			}
+
+			// Rare, so just copy; the file can't be rewritten while it is mapped
+			std::vector<uint8_t> refreshedCache(cache.GetData(), cache.GetData() + cache.GetSize());
+			std::vector<byte_t> refreshedTime;
+			BufferWriter timeWriter(refreshedTime, EndianMode::LITTLE);
+			timeWriter.AppendInt64(stamp.m_writeTime);
+			std::copy(refreshedTime.begin(), refreshedTime.end(), refreshedCache.begin() + DEFINITION_CACHE_WRITE_TIME_OFFSET);
+			cache.Close();
+			FileWriteFromBuffer(refreshedCache, cachePath);
+
+			BufferParser refreshedParser(refreshedCache.data(), refreshedCache.size(), EndianMode::LITTLE);
+			refreshedParser.JumpToOffset(DEFINITION_CACHE_HEADER_SIZE);
+			readDefinitions(refreshedParser);
+			return refreshedParser.GetOffset() == refreshedParser.GetSize();
+		}
+
+		readDefinitions(parser);
+		return parser.GetOffset() == parser.GetSize();
+	}
+	catch (std::runtime_error const&)
+	{
+		return false; // Truncated or corrupt; the caller rebuilds it from the XML
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+void SaveDefinitionCache(std::string const& sourcePath, uint32_t definitionVersion, std::function<void(BufferWriter& writer)> const& writeDefinitions)
+{
+	DefinitionSourceStamp stamp;
+	MappedFile source;
+	if (!GetDefinitionSourceStamp(sourcePath, stamp) || !source.Open(sourcePath))
+	{
+		return;
+	}
+
+	std::vector<byte_t> cache;
+	BufferWriter writer(cache, EndianMode::LITTLE);
+	writer.AppendUInt(DEFINITION_CACHE_MAGIC);
+	writer.AppendUInt(DEFINITION_CACHE_FORMAT);
+	writer.AppendUInt(definitionVersion);
+	writer.AppendUInt64(stamp.m_size);
+	writer.AppendInt64(stamp.m_writeTime);
+	writer.AppendUInt64(HashDefinitionSource(source.GetBytes()));
+	writer.AppendUInt(0);
+
+	writeDefinitions(writer);
+	writer.OverwriteUInt32At(DEFINITION_CACHE_HEADER_SIZE - sizeof(uint32_t), static_cast<uint32_t>(cache.size() - DEFINITION_CACHE_HEADER_SIZE));
+
+	FileWriteFromBuffer(cache, GetDefinitionCachePath(sourcePath));
+}
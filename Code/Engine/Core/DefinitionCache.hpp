@@ -0,0 +1,20 @@
+#pragma once
+#include "Engine/Core/BufferParser.hpp"
+#include "Engine/Core/BufferWriter.hpp"
+#include <functional>
+#include <string>
+
+
+//------------------------------------------------------------------------------------------------
+// Compiled definition caches: the parsed results of an XML definition file are written to
+// "<sourcePath>.bin" and parsed in place from a file mapping on later runs, skipping tinyxml2 and
+// ParseXmlAttribute entirely. A cache is only used if its definitionVersion matches and the source is
+// unchanged: same size and write time, or (if only the time moved, e.g. after a checkout) same content hash.
+// Bump definitionVersion whenever the serialized layout of a definition type changes.
+std::string GetDefinitionCachePath(std::string const& sourcePath);
+
+// Calls readDefinitions on the cached payload; returns false (and the caller should parse the XML) if the cache
+// is missing, stale, or readDefinitions ran off the end of it. readDefinitions should fill a temporary, since a
+// truncated cache can fail part way through.
+bool LoadDefinitionCache(std::string const& sourcePath, uint32_t definitionVersion, std::function<void(BufferParser& parser)> const& readDefinitions);
+void SaveDefinitionCache(std::string const& sourcePath, uint32_t definitionVersion, std::function<void(BufferWriter& writer)> const& writeDefinitions);
@@ -52,7 +52,7 @@ void DevConsole::Startup()
 	m_fontPath = "Data/Fonts/" + m_config.m_fontName;
 	m_defaultFont = m_config.m_renderer->CreateOrGetBitmapFont(m_fontPath.c_str());
 
-	g_theEventSystem->SubscribeEventCallbackFunction("CharInput", DevConsole::Event_CharInput);
+	g_theEventSystem->Subscribe(DevConsole::Event_CharInput);
 	g_theEventSystem->SubscribeEventCallbackFunction("help", DevConsole::Command_Help);
 	g_theEventSystem->SubscribeEventCallbackFunction("clear", DevConsole::Command_Clear);
 
@@ -82,19 +82,13 @@ void DevConsole::EndFrame()
 
 void DevConsole::Execute(std::string const& consoleCommandText, bool echoCommand) 
 {
-	Strings commandLines = SplitStringOnDelimiter(consoleCommandText, '\n');
-
-	for (const std::string& line : commandLines) {
-		if (line.empty()) {
+	for (StringView lineView : StringViewSplitter(consoleCommandText, '\n')) {
+		StringViewSplitter parts(lineView, ' ');
+		if (parts.begin() == parts.end()) {
 			continue;
 		}
 
-		Strings parts = SplitStringOnDelimiter(line, ' ');
-		if (parts.empty()) {
-			continue;
-		}
-
-		std::string commandName = parts[0];
+		StringView commandName = *parts.begin();
 
 		/*
 		bool isNoArgCommand = false;
@@ -116,14 +110,15 @@ void DevConsole::Execute(std::string const& consoleCommandText, bool echoCommand
 
 		EventArgs arguments;
 
-		for (int i = 1; i < (int)parts.size(); ++i) 
+		for (StringViewSplitter::Iterator part = ++parts.begin(); part != parts.end(); ++part)
 		{
-			Strings keyValue = SplitStringOnDelimiter(parts[i], '=');
-			if (keyValue.size() == 2) {
-				arguments.SetValue(keyValue[0], keyValue[1]);
+			StringView keyValue[2];
+			if (SplitStringViewOnDelimiter(*part, '=', keyValue, 2) == 2) {
+				arguments.SetValue(std::string(keyValue[0]), std::string(keyValue[1]));
 			}
 		}
 
+		std::string line(lineView);
 		g_theDevConsole->AddLine(DevConsole::ECHO, line);
 
 		if (m_commandHistory.empty() || m_commandHistory.back() != line) 
@@ -133,10 +128,8 @@ void DevConsole::Execute(std::string const& consoleCommandText, bool echoCommand
 		m_historyIndex = (int)m_commandHistory.size();
 
 
-		std::transform(commandName.begin(), commandName.end(), commandName.begin(),
-			[](unsigned char c) { return (char)std::tolower(c); });
-
-		bool success = g_theEventSystem->FireEvent(commandName, arguments);
+		// EventIDs are case-folded, so the command name needs no lowercase copy
+		bool success = g_theEventSystem->FireEvent(EventID(commandName), arguments);
 
 		if (echoCommand && g_theDevConsole) 
 		{
@@ -230,13 +223,13 @@ bool DevConsole::IsOpen() const
 	return m_isOpen;
 }
 
-bool DevConsole::Event_KeyPressed(EventArgs& args)
+bool DevConsole::Event_KeyPressed(KeyPressedEvent const& keyEvent)
 {
 	if (!g_theDevConsole)
 	{
 		return false;
 	}
-	unsigned char keyCode = (unsigned char)args.GetValue("KeyCode", -1);
+	unsigned char keyCode = keyEvent.m_keyCode;
 	if (keyCode == KEYCODE_ENTER)
 	{
 		if (g_theDevConsole->m_inputText.empty())
@@ -323,14 +316,14 @@ bool DevConsole::Event_KeyPressed(EventArgs& args)
 	return false;
 }
 
-bool DevConsole::Event_CharInput(EventArgs& args)
+bool DevConsole::Event_CharInput(CharInputEvent const& charEvent)
 {
 	if (!g_theDevConsole)
 	{
 		return false;
 	}
 
-	char ch = (char) args.GetValue("Char", '\0');
+	char ch = charEvent.m_char;
 	if (ch == '\0') {
 		return false;
 	}
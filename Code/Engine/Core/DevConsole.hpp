@@ -13,6 +13,8 @@ class Camera;
 class BitmapFont;
 class Timer;
 struct AABB2;
+struct KeyPressedEvent;
+struct CharInputEvent;
 
 class DevConsole;
 extern DevConsole* g_theDevConsole;
@@ -86,8 +88,8 @@ public:
 	static const Rgba8 NET_WARNING;
 	static const Rgba8 NET_ERROR;
 
-	static bool Event_KeyPressed(EventArgs& args);
-	static bool Event_CharInput(EventArgs& args);
+	static bool Event_KeyPressed(KeyPressedEvent const& keyEvent);
+	static bool Event_CharInput(CharInputEvent const& charEvent);
 	static bool Command_Clear(EventArgs& args);
 	static bool Command_Help(EventArgs& args);
 
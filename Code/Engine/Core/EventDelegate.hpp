@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+
+//------------------------------------------------------------------------------------------------
+// Type-erased event callback held in place: a free function, an object + member function, or a small
+// lambda. Captures must be trivially copyable and fit in EVENT_DELEGATE_STORAGE_BYTES, so delegates sit
+// in plain arrays and are copied around freely with no heap allocation and no destructor to run.
+// Arg is the callback's parameter type (EventArgs& or TEvent const&); Invoke takes a pointer to the argument.
+constexpr size_t EVENT_DELEGATE_STORAGE_BYTES = 32;
+
+class EventDelegate
+{
+public:
+	EventDelegate() = default;
+
+	template <typename Arg, typename Callable>
+	static EventDelegate FromCallable(Callable const& callable)
+	{
+		static_assert(sizeof(Callable) <= EVENT_DELEGATE_STORAGE_BYTES, "Event callback captures too much; capture a pointer instead");
+		static_assert(alignof(Callable) <= alignof(std::max_align_t), "Event callback capture alignment too strict");
+		static_assert(std::is_trivially_copyable<Callable>::value, "Event callbacks must be trivially copyable; capture pointers and plain values only");
+
+		EventDelegate delegate;
+		new (delegate.m_storage) Callable(callable);
+		delegate.m_invoke = &InvokeCallable<Arg, Callable>;
+		return delegate;
+	}
+
+	template <typename Arg>
+	static EventDelegate FromFunction(bool (*function)(Arg))
+	{
+		return FromCallable<Arg>(function);
+	}
+
+	template <typename Arg, typename Object>
+	static EventDelegate FromMethod(Object* object, bool (Object::*method)(Arg))
+	{
+		return FromCallable<Arg>(BoundMethod<Arg, Object>{ object, method });
+	}
+
+	// True if this delegate was made by FromFunction(function); lets callers unsubscribe by function pointer
+	template <typename Arg>
+	bool IsFunction(bool (*function)(Arg)) const
+	{
+		typedef bool (*FunctionPointer)(Arg);
+		return m_invoke == &InvokeCallable<Arg, FunctionPointer> && *reinterpret_cast<FunctionPointer const*>(m_storage) == function;
+	}
+
+	bool IsBound() const { return m_invoke != nullptr; }
+	bool Invoke(void* arg) const { return m_invoke(m_storage, arg); }
+
+private:
+	template <typename Arg, typename Object>
+	struct BoundMethod
+	{
+		bool operator()(Arg arg) const { return (m_object->*m_method)(arg); }
+
+		Object* m_object;
+		bool (Object::*m_method)(Arg);
+	};
+
+	template <typename Arg, typename Callable>
+	static bool InvokeCallable(void const* storage, void* arg)
+	{
+		typedef typename std::remove_reference<Arg>::type ArgType;
+		return (*static_cast<Callable const*>(storage))(*static_cast<ArgType*>(arg));
+	}
+
+private:
+	alignas(std::max_align_t) unsigned char m_storage[EVENT_DELEGATE_STORAGE_BYTES] = {};
+	bool (*m_invoke)(void const* storage, void* arg) = nullptr;
+};
@@ -1,15 +1,50 @@
 ﻿#include "Engine/Core/EventSystem.hpp"
 #include "Engine/Input/NamedStrings.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <atomic>
 
 
 extern EventSystem* g_theEventSystem;
 
-void EventSystem::SubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction* func)
+
+//------------------------------------------------------------------------------------------------
+EventSystem::~EventSystem()
 {
-	std::scoped_lock lock(m_eventMutex);
-	SubscriptionList& subscribersForThisEvent = m_subscriptionListsByEventName[eventName];
-	EventSubscription* newEventSubscription = new EventSubscription(func);
-	subscribersForThisEvent.push_back(newEventSubscription); // #ToDo: check for null entries to fill in first
+	Shutdown();
+}
+
+
+//------------------------------------------------------------------------------------------------
+void EventSystem::Shutdown()
+{
+	// Undelivered events are dropped; nothing should be listening any more
+	while (QueuedEvent* queuedEvent = m_queuedEvents.Pop())
+	{
+		delete queuedEvent->m_args;
+		delete queuedEvent;
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+void EventSystem::BeginFrame()
+{
+	DeliverQueuedEvents();
+}
+
+
+//------------------------------------------------------------------------------------------------
+void EventSystem::EndFrame()
+{
+	DeliverQueuedEvents();
+}
+
+
+//------------------------------------------------------------------------------------------------
+EventSubscriptionHandle EventSystem::SubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction* func)
+{
+	return AddNamedSubscriber(eventName, EventDelegate::FromFunction<EventArgs&>(func));
 }
 
 
@@ -17,81 +52,414 @@ void EventSystem::SubscribeEventCallbackFunction(std::string const& eventName, E
 void EventSystem::UnsubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction* func)
 {
 	std::scoped_lock lock(m_eventMutex);
-	std::map< std::string, SubscriptionList >::iterator found = m_subscriptionListsByEventName.find(eventName);
-	if (found == m_subscriptionListsByEventName.end())
+	RegisteredEvent* registeredEvent = FindEvent(EventID(eventName));
+	if (registeredEvent == nullptr)
 	{
 		return; // Nobody subscribed to this event
 	}
 
-	SubscriptionList& subscribersForThisEvent = found->second;
-	int numSubscribers = static_cast<int>(subscribersForThisEvent.size());
-	for (int i = 0; i < numSubscribers; ++i)
+	UnsubscribeFunction(&registeredEvent->m_subscriberList, func);
+}
+
+
+//------------------------------------------------------------------------------------------------
+void EventSystem::Unsubscribe(EventSubscriptionHandle& handle)
+{
+	std::scoped_lock lock(m_eventMutex);
+	if (handle.m_slotIndex < m_subscriptionSlots.size() && m_subscriptionSlots[handle.m_slotIndex].m_generation == handle.m_generation)
 	{
-		EventSubscription*& subscriber = subscribersForThisEvent[i];
-		if (subscriber && subscriber->m_functionPtr == func)
+		SubscriptionSlot const& slot = m_subscriptionSlots[handle.m_slotIndex];
+		SubscriberList* list = GetSubscriberList(slot.m_listIndex, slot.m_isTyped);
+		if (list)
 		{
-			subscriber = nullptr;
+			for (Subscriber& subscriber : list->m_subscribers)
+			{
+				if (subscriber.m_slotIndex == handle.m_slotIndex && subscriber.m_delegate.IsBound())
+				{
+					UnbindSubscriber(*list, subscriber);
+					break;
+				}
+			}
+			CompactIfIdle(*list);
 		}
 	}
+	handle = EventSubscriptionHandle();
 }
 
 
 //------------------------------------------------------------------------------------------------
-int EventSystem::FireEvent(std::string const& eventName, EventArgs& args)
+EventSubscriptionHandle EventSystem::AddNamedSubscriber(std::string const& eventName, EventDelegate const& delegate)
 {
 	std::scoped_lock lock(m_eventMutex);
-	printf("  Firing event \"%s\"...\n", eventName.c_str());
+	FindOrAddEvent(eventName);
+	return AddSubscriber(FindEventIndex(EventID(eventName)), false, delegate);
+}
+
+
+//------------------------------------------------------------------------------------------------
+EventSubscriptionHandle EventSystem::AddTypedSubscriber(int typedEventIndex, EventDelegate const& delegate)
+{
+	std::scoped_lock lock(m_eventMutex);
+	if (typedEventIndex >= static_cast<int>(m_typedSubscriberLists.size()))
+	{
+		m_typedSubscriberLists.resize(typedEventIndex + 1);
+	}
+	return AddSubscriber(typedEventIndex, true, delegate);
+}
+
+
+//------------------------------------------------------------------------------------------------
+EventSubscriptionHandle EventSystem::AddSubscriber(int listIndex, bool isTyped, EventDelegate const& delegate)
+{
+	uint32_t slotIndex = 0;
+	if (!m_freeSubscriptionSlots.empty())
+	{
+		slotIndex = m_freeSubscriptionSlots.back();
+		m_freeSubscriptionSlots.pop_back();
+	}
+	else
+	{
+		slotIndex = static_cast<uint32_t>(m_subscriptionSlots.size());
+		m_subscriptionSlots.push_back(SubscriptionSlot());
+	}
+
+	SubscriptionSlot& slot = m_subscriptionSlots[slotIndex];
+	slot.m_listIndex = listIndex;
+	slot.m_isTyped = isTyped;
+
+	Subscriber subscriber;
+	subscriber.m_delegate = delegate;
+	subscriber.m_slotIndex = slotIndex;
+	GetSubscriberList(listIndex, isTyped)->m_subscribers.push_back(subscriber);
+
+	EventSubscriptionHandle handle;
+	handle.m_slotIndex = slotIndex;
+	handle.m_generation = slot.m_generation;
+	return handle;
+}
+
+
+//------------------------------------------------------------------------------------------------
+EventSystem::SubscriberList* EventSystem::GetSubscriberList(int listIndex, bool isTyped)
+{
+	if (listIndex < 0)
+	{
+		return nullptr;
+	}
+	if (isTyped)
+	{
+		return (listIndex < static_cast<int>(m_typedSubscriberLists.size())) ? &m_typedSubscriberLists[listIndex] : nullptr;
+	}
+	return (listIndex < static_cast<int>(m_events.size())) ? &m_events[listIndex].m_subscriberList : nullptr;
+}
+
+
+//------------------------------------------------------------------------------------------------
+void EventSystem::UnbindSubscriber(SubscriberList& list, Subscriber& subscriber)
+{
+	// Bumping the generation makes every outstanding handle to this slot stale before the slot is reused
+	SubscriptionSlot& slot = m_subscriptionSlots[subscriber.m_slotIndex];
+	++slot.m_generation;
+	slot.m_listIndex = -1;
+	m_freeSubscriptionSlots.push_back(subscriber.m_slotIndex);
+
+	subscriber.m_delegate = EventDelegate();
+	++list.m_numUnbound;
+}
+
+
+//------------------------------------------------------------------------------------------------
+void EventSystem::CompactIfIdle(SubscriberList& list)
+{
+	if (list.m_numUnbound == 0)
+	{
+		return;
+	}
+	if (m_firingDepth > 0)
+	{
+		m_hasUnboundSubscribers = true; // A Fire further up the stack is indexing this list; compact when it returns
+		return;
+	}
+
+	list.m_subscribers.erase(std::remove_if(list.m_subscribers.begin(), list.m_subscribers.end(), [](Subscriber const& subscriber)
+		{
+			return !subscriber.m_delegate.IsBound();
+		}), list.m_subscribers.end());
+	list.m_numUnbound = 0;
+}
+
+
+//------------------------------------------------------------------------------------------------
+int EventSystem::InvokeSubscribers(int listIndex, bool isTyped, void* arg, bool* outWasConsumed)
+{
+	if (outWasConsumed)
+	{
+		*outWasConsumed = false;
+	}
 
-	std::map< std::string, SubscriptionList >::iterator found = m_subscriptionListsByEventName.find(eventName);
-	if (found == m_subscriptionListsByEventName.end())
+	SubscriberList* list = GetSubscriberList(listIndex, isTyped);
+	if (list == nullptr)
 	{
 		return 0; // Nobody subscribed to this event
 	}
 
-	// Found a list of subscribers for this event; call each one in turn (or until someone "consumes" the event)
-	SubscriptionList& subscribersForThisEvent = found->second;
-	int numSubscribers = static_cast<int>(subscribersForThisEvent.size());
+	// Call each subscriber in turn (or until someone "consumes" the event). Callbacks may subscribe and grow
+	// the lists, so look the list up again every time and call a copy of the delegate, never the stored one.
+	++m_firingDepth;
+	int numSubscribers = static_cast<int>(list->m_subscribers.size());
+	int numCalled = 0;
 	for (int i = 0; i < numSubscribers; ++i)
 	{
-		EventSubscription* subscriber = subscribersForThisEvent[i];
-		if (subscriber)
+		EventDelegate delegate = GetSubscriberList(listIndex, isTyped)->m_subscribers[i].m_delegate;
+		if (delegate.IsBound())
 		{
-			bool wasConsumed = subscriber->m_functionPtr(args); // Execute the subscriber's callback function!
+			++numCalled;
+			bool wasConsumed = delegate.Invoke(arg);
 			if (wasConsumed)
 			{
+				if (outWasConsumed)
+				{
+					*outWasConsumed = true;
+				}
 				break; // Event was "consumed" by this subscriber; stop notifying any other subscribers!
 			}
 		}
 	}
+	--m_firingDepth;
 
-	return numSubscribers;
+	if (m_firingDepth == 0 && m_hasUnboundSubscribers)
+	{
+		m_hasUnboundSubscribers = false;
+		for (RegisteredEvent& registeredEvent : m_events)
+		{
+			CompactIfIdle(registeredEvent.m_subscriberList);
+		}
+		for (SubscriberList& typedList : m_typedSubscriberLists)
+		{
+			CompactIfIdle(typedList);
+		}
+	}
+	return numCalled;
+}
+
+
+//------------------------------------------------------------------------------------------------
+// Called with m_eventMutex held
+int EventSystem::InvokeNamedSubscribersWithArgs(EventID eventID, EventDelegate const& fillArgs)
+{
+	int eventIndex = FindEventIndex(eventID);
+	if (eventIndex < 0)
+	{
+		return 0;
+	}
+	SubscriberList const& list = m_events[eventIndex].m_subscriberList;
+	if (static_cast<int>(list.m_subscribers.size()) <= list.m_numUnbound)
+	{
+		return 0; // Everyone has unsubscribed; don't build args for nobody
+	}
+
+	EventArgs args;
+	fillArgs.Invoke(&args);
+	return InvokeSubscribers(eventIndex, false, &args);
+}
+
+
+//------------------------------------------------------------------------------------------------
+int EventSystem::FireEvent(std::string const& eventName, EventArgs& args)
+{
+	return FireEvent(EventID(eventName), args);
 }
 
 
 //------------------------------------------------------------------------------------------------
 int EventSystem::FireEvent(std::string const& eventName)
+{
+	EventArgs emptyArgs;
+	return FireEvent(EventID(eventName), emptyArgs);
+}
+
+
+//------------------------------------------------------------------------------------------------
+int EventSystem::FireEvent(EventID eventID, EventArgs& args)
 {
 	std::scoped_lock lock(m_eventMutex);
+	return InvokeSubscribers(FindEventIndex(eventID), false, &args);
+}
+
+
+//------------------------------------------------------------------------------------------------
+int EventSystem::FireEvent(EventID eventID)
+{
 	EventArgs emptyArgs;
-	return FireEvent(eventName, emptyArgs);
+	return FireEvent(eventID, emptyArgs);
+}
+
+//------------------------------------------------------------------------------------------------
+void EventSystem::QueueEvent(std::string const& eventName, EventArgs const& args)
+{
+	QueueEvent(EventID(eventName), args);
+}
+
+
+//------------------------------------------------------------------------------------------------
+void EventSystem::QueueEvent(std::string const& eventName)
+{
+	QueueEvent(EventID(eventName), EventArgs());
+}
+
+
+//------------------------------------------------------------------------------------------------
+void EventSystem::QueueEvent(EventID eventID, EventArgs const& args)
+{
+	QueuedEvent* queuedEvent = new QueuedEvent();
+	queuedEvent->m_eventID = eventID;
+	queuedEvent->m_args = new EventArgs(args);
+	m_queuedEvents.Push(queuedEvent);
+}
+
+
+//------------------------------------------------------------------------------------------------
+void EventSystem::QueueEvent(EventID eventID)
+{
+	QueueEvent(eventID, EventArgs());
+}
+
+
+//------------------------------------------------------------------------------------------------
+int EventSystem::DeliverQueuedEvents()
+{
+	// Take everything queued so far in one go; events queued by the callbacks below go out next time
+	m_eventsBeingDelivered.clear();
+	m_queuedEvents.PopMany(m_eventsBeingDelivered);
+
+	for (QueuedEvent* queuedEvent : m_eventsBeingDelivered)
+	{
+		FireEvent(queuedEvent->m_eventID, *queuedEvent->m_args);
+		delete queuedEvent->m_args;
+		delete queuedEvent;
+	}
+
+	int numDelivered = static_cast<int>(m_eventsBeingDelivered.size());
+	m_eventsBeingDelivered.clear();
+	return numDelivered;
 }
 
+
+//------------------------------------------------------------------------------------------------
+int EventSystem::AllocateTypedEventIndex()
+{
+	static std::atomic<int> s_numTypedEvents = 0;
+	return s_numTypedEvents.fetch_add(1);
+}
+
+
+//------------------------------------------------------------------------------------------------
 std::vector<std::string> EventSystem::GetRegisteredEventNames() const
 {
 	std::scoped_lock lock(m_eventMutex);
 	std::vector<std::string> eventNames;
-	for (const auto& pair : m_subscriptionListsByEventName) {
-		eventNames.push_back(pair.first);
+	for (RegisteredEvent const& registeredEvent : m_events) {
+		if (static_cast<int>(registeredEvent.m_subscriberList.m_subscribers.size()) > registeredEvent.m_subscriberList.m_numUnbound) {
+			eventNames.push_back(registeredEvent.m_eventName);
+		}
 	}
+	std::sort(eventNames.begin(), eventNames.end(), cmpCaseInsensitive());
 	return eventNames;
 }
 
-void SubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction* func)
+
+//------------------------------------------------------------------------------------------------
+EventSystem::RegisteredEvent* EventSystem::FindEvent(EventID eventID)
+{
+	int eventIndex = FindEventIndex(eventID);
+	return (eventIndex >= 0) ? &m_events[eventIndex] : nullptr;
+}
+
+
+//------------------------------------------------------------------------------------------------
+EventSystem::RegisteredEvent& EventSystem::FindOrAddEvent(std::string const& eventName)
+{
+	EventID eventID(eventName);
+	int eventIndex = FindEventIndex(eventID);
+	if (eventIndex >= 0)
+	{
+		RegisteredEvent& registeredEvent = m_events[eventIndex];
+		GUARANTEE_OR_DIE(AreStringsEqualCaseInsensitive(registeredEvent.m_eventName, eventName), Stringf("Event names \"%s\" and \"%s\" hash to the same EventID", registeredEvent.m_eventName.c_str(), eventName.c_str()));
+		return registeredEvent;
+	}
+
+	// Keep the table at most half full so probes stay short
+	if ((m_events.size() + 1) * 2 > m_eventTableHashes.size())
+	{
+		RebuildEventTable(std::max<size_t>(64, m_eventTableHashes.size() * 2));
+	}
+
+	RegisteredEvent newEvent;
+	newEvent.m_eventID = eventID;
+	newEvent.m_eventName = eventName;
+	m_events.push_back(newEvent);
+
+	size_t mask = m_eventTableHashes.size() - 1;
+	size_t slot = static_cast<size_t>(eventID.GetHash()) & mask;
+	while (m_eventTableHashes[slot] != 0)
+	{
+		slot = (slot + 1) & mask;
+	}
+	m_eventTableHashes[slot] = eventID.GetHash();
+	m_eventTableIndices[slot] = static_cast<int>(m_events.size()) - 1;
+	return m_events.back();
+}
+
+
+//------------------------------------------------------------------------------------------------
+int EventSystem::FindEventIndex(EventID eventID) const
+{
+	if (m_eventTableHashes.empty() || !eventID.IsValid())
+	{
+		return -1;
+	}
+
+	size_t mask = m_eventTableHashes.size() - 1;
+	for (size_t slot = static_cast<size_t>(eventID.GetHash()) & mask; m_eventTableHashes[slot] != 0; slot = (slot + 1) & mask)
+	{
+		if (m_eventTableHashes[slot] == eventID.GetHash())
+		{
+			return m_eventTableIndices[slot];
+		}
+	}
+	return -1;
+}
+
+
+//------------------------------------------------------------------------------------------------
+void EventSystem::RebuildEventTable(size_t numSlots)
+{
+	m_eventTableHashes.assign(numSlots, 0);
+	m_eventTableIndices.assign(numSlots, -1);
+
+	size_t mask = numSlots - 1;
+	for (int eventIndex = 0; eventIndex < static_cast<int>(m_events.size()); ++eventIndex)
+	{
+		uint64_t hash = m_events[eventIndex].m_eventID.GetHash();
+		size_t slot = static_cast<size_t>(hash) & mask;
+		while (m_eventTableHashes[slot] != 0)
+		{
+			slot = (slot + 1) & mask;
+		}
+		m_eventTableHashes[slot] = hash;
+		m_eventTableIndices[slot] = eventIndex;
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+EventSubscriptionHandle SubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction* func)
 {
 	if (g_theEventSystem != nullptr)
 	{
-		g_theEventSystem->SubscribeEventCallbackFunction(eventName, func);
+		return g_theEventSystem->SubscribeEventCallbackFunction(eventName, func);
 	}
+	return EventSubscriptionHandle();
 }
 
 void UnsubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction* func)
@@ -121,8 +489,52 @@ int FireEvent(std::string const& eventName)
 	return 0;
 }
 
+int FireEvent(EventID eventID, EventArgs& args)
+{
+	if (g_theEventSystem != nullptr)
+	{
+		return g_theEventSystem->FireEvent(eventID, args);
+	}
+	return 0;
+}
 
+int FireEvent(EventID eventID)
+{
+	if (g_theEventSystem != nullptr)
+	{
+		return g_theEventSystem->FireEvent(eventID);
+	}
+	return 0;
+}
 
+void QueueEvent(std::string const& eventName, EventArgs const& args)
+{
+	if (g_theEventSystem != nullptr)
+	{
+		g_theEventSystem->QueueEvent(eventName, args);
+	}
+}
 
+void QueueEvent(std::string const& eventName)
+{
+	if (g_theEventSystem != nullptr)
+	{
+		g_theEventSystem->QueueEvent(eventName);
+	}
+}
 
+void QueueEvent(EventID eventID, EventArgs const& args)
+{
+	if (g_theEventSystem != nullptr)
+	{
+		g_theEventSystem->QueueEvent(eventID, args);
+	}
+}
 
+void QueueEvent(EventID eventID)
+{
+	if (g_theEventSystem != nullptr)
+	{
+		g_theEventSystem->QueueEvent(eventID);
+	}
+}
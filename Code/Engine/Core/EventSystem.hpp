@@ -5,6 +5,11 @@
 #include <cctype>
 #include <string>
 #include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include "Engine/Core/MPSCQueue.hpp"
+#include "Engine/Core/EventDelegate.hpp"
+#include "Engine/Core/StringUtils.hpp"
 
 
 class NamedStrings;
@@ -16,28 +21,74 @@ struct EventSystemConfig
 
 };
 
-struct EventSubscription
+struct cmpCaseInsensitive {
+	bool operator()(const std::string& a, const std::string& b) const {
+		return CompareStringsCaseInsensitive(a, b) < 0;
+	}
+};
+
+
+//------------------------------------------------------------------------------------------------
+// Identifies one subscription. The generation makes a handle go stale once it has been unsubscribed,
+// so unsubscribing twice (or with a handle whose slot was since reused) is harmless.
+struct EventSubscriptionHandle
 {
-	EventSubscription(EventCallbackFunction* functionPtr)
-		: m_functionPtr(functionPtr) {}
+	static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+	bool IsValid() const { return m_slotIndex != INVALID_INDEX; }
 
-	EventCallbackFunction* m_functionPtr = nullptr;
+	uint32_t m_slotIndex = INVALID_INDEX;
+	uint32_t m_generation = 0;
 };
 
-struct cmpCaseInsensitive {
-	bool operator()(const std::string& a, const std::string& b) const {
-		std::string lowerCaseA = a;
-		std::string lowerCaseB = b;
-		std::transform(lowerCaseA.begin(), lowerCaseA.end(), lowerCaseA.begin(),
-			[](unsigned char c) { return (char)std::tolower(c); });
-		std::transform(lowerCaseB.begin(), lowerCaseB.end(), lowerCaseB.begin(),
-			[](unsigned char c) { return (char)std::tolower(c); });
-
-		return lowerCaseA < lowerCaseB;
+
+//------------------------------------------------------------------------------------------------
+// An event name reduced to a case-folded 64-bit FNV-1a hash, so "KeyPressed" and "keypressed" are the
+// same event. Build IDs for hot events once (they are constexpr) and fire by ID to skip hashing:
+//	constexpr EventID EVENT_KEY_PRESSED("KeyPressed");
+//	FireEvent(EVENT_KEY_PRESSED, args);
+class EventID
+{
+public:
+	constexpr EventID() = default;
+	constexpr explicit EventID(char const* eventName) : m_hash(HashEventName(eventName, GetLength(eventName))) {}
+	explicit EventID(std::string_view eventName) : m_hash(HashEventName(eventName.data(), eventName.size())) {}
+
+	constexpr uint64_t GetHash() const { return m_hash; }
+	constexpr bool IsValid() const { return m_hash != 0; }
+	constexpr bool operator==(EventID const& compare) const { return m_hash == compare.m_hash; }
+	constexpr bool operator!=(EventID const& compare) const { return m_hash != compare.m_hash; }
+
+	static constexpr uint64_t HashEventName(char const* eventName, size_t length)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < length; ++i)
+		{
+			char c = eventName[i];
+			if (c >= 'A' && c <= 'Z')
+			{
+				c = static_cast<char>(c - 'A' + 'a');
+			}
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 1099511628211ull;
+		}
+		return (hash != 0) ? hash : 1; // 0 marks an invalid ID and an empty table slot
 	}
-};
 
-typedef std::vector<EventSubscription*>		SubscriptionList; // Note: a list of pointers
+private:
+	static constexpr size_t GetLength(char const* text)
+	{
+		size_t length = 0;
+		while (text[length] != '\0')
+		{
+			++length;
+		}
+		return length;
+	}
+
+private:
+	uint64_t m_hash = 0;
+};
 
 class EventSystem
 {
@@ -45,31 +96,218 @@ public:
 	EventSystem(EventSystemConfig const& config)
 		: m_config(config) {}
 
-	~EventSystem() {}
+	~EventSystem();
 	void Startup() {}
-	void Shutdown() {}
-	void BeginFrame() {}
-	void EndFrame() {}
+	void Shutdown();
+	void BeginFrame(); // Delivers queued events
+	void EndFrame(); // Delivers queued events
 
-	void SubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction* func);
+	EventSubscriptionHandle SubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction* func);
+	template <typename Object>
+	EventSubscriptionHandle SubscribeEventCallbackMethod(std::string const& eventName, Object* object, bool (Object::*method)(EventArgs& args));
+	template <typename Callable>
+	EventSubscriptionHandle SubscribeEventCallable(std::string const& eventName, Callable const& callable); // A small lambda; see EventDelegate
 	void UnsubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction* func);
+	void Unsubscribe(EventSubscriptionHandle& handle); // Named or typed; resets the handle, ignores stale ones
+
 	int	FireEvent(std::string const& eventName, EventArgs& args);
 	int	FireEvent(std::string const& eventName); // Calls the above function with a temporary empty args
+	int	FireEvent(EventID eventID, EventArgs& args); // Returns the number of subscribers called
+	int	FireEvent(EventID eventID);
+
+	// Safe from any thread and never blocks on subscribers: the event is delivered on the main thread in the next
+	// BeginFrame/EndFrame, in the order the queue calls completed. Events queued during delivery wait for the next one.
+	void QueueEvent(std::string const& eventName, EventArgs const& args);
+	void QueueEvent(std::string const& eventName);
+	void QueueEvent(EventID eventID, EventArgs const& args);
+	void QueueEvent(EventID eventID);
+	int	DeliverQueuedEvents(); // Returns how many queued events were fired
+
+	// Typed events: any struct is an event type, and subscribers receive it by const reference. Nothing is
+	// formatted, parsed or allocated per fire, which suits per-frame events (input, network messages).
+	// DevConsole commands and other string-driven events keep using the NamedStrings form above.
+	template <typename TEvent>
+	EventSubscriptionHandle Subscribe(bool (*callback)(TEvent const& event));
+	template <typename TEvent, typename Object>
+	EventSubscriptionHandle Subscribe(Object* object, bool (Object::*method)(TEvent const& event));
+	template <typename TEvent, typename Callable>
+	EventSubscriptionHandle SubscribeCallable(Callable const& callable); // e.g. SubscribeCallable<KeyPressedEvent>([this](KeyPressedEvent const& keyEvent) { ... })
+	template <typename TEvent>
+	void Unsubscribe(bool (*callback)(TEvent const& event));
+	template <typename TEvent>
+	int	Fire(TEvent const& event, bool* outWasConsumed = nullptr); // Returns the number of subscribers called; stops early if one consumes it
+
+	// For events sent both ways (e.g. key input): fires the typed event, then, unless a typed subscriber consumed
+	// it, the named one. fillArgs is a small lambda, (EventArgs& args) -> bool, only called if the named event
+	// has subscribers, so nothing is formatted for nobody. Everything happens under one lock.
+	template <typename TEvent, typename FillArgs>
+	int	FireTypedAndNamed(TEvent const& event, EventID namedEventID, FillArgs const& fillArgs);
 
 	std::vector<std::string> GetRegisteredEventNames() const;
 
 private:
-	EventSystemConfig							m_config;
-	std::map<std::string, SubscriptionList, cmpCaseInsensitive> m_subscriptionListsByEventName;
-	mutable std::recursive_mutex m_eventMutex;
+	// Unsubscribed entries are unbound in place and squeezed out as soon as no Fire is walking the list
+	struct Subscriber
+	{
+		EventDelegate	m_delegate;
+		uint32_t		m_slotIndex = 0;
+	};
+	struct SubscriberList
+	{
+		std::vector<Subscriber>	m_subscribers;
+		int						m_numUnbound = 0;
+	};
+	struct SubscriptionSlot
+	{
+		uint32_t	m_generation = 0;
+		int			m_listIndex = -1; // Index into m_events or m_typedSubscriberLists; -1 while the slot is free
+		bool		m_isTyped = false;
+	};
+
+	template <typename TEvent>
+	static int GetTypedEventIndex();
+	static int AllocateTypedEventIndex();
+
+	struct QueuedEvent
+	{
+		EventID			m_eventID;
+		EventArgs*		m_args = nullptr; // Owned; a pointer because NamedStrings can't be included here
+		QueuedEvent*	m_nextInQueue = nullptr;
+	};
+	struct RegisteredEvent
+	{
+		EventID				m_eventID;
+		std::string			m_eventName; // Spelling from the first subscription; used for listing and collision checks
+		SubscriberList		m_subscriberList;
+	};
+
+	RegisteredEvent* FindEvent(EventID eventID);
+	RegisteredEvent& FindOrAddEvent(std::string const& eventName);
+	int FindEventIndex(EventID eventID) const;
+	void RebuildEventTable(size_t numSlots);
+
+	EventSubscriptionHandle AddNamedSubscriber(std::string const& eventName, EventDelegate const& delegate);
+	EventSubscriptionHandle AddTypedSubscriber(int typedEventIndex, EventDelegate const& delegate);
+	EventSubscriptionHandle AddSubscriber(int listIndex, bool isTyped, EventDelegate const& delegate);
+	SubscriberList* GetSubscriberList(int listIndex, bool isTyped);
+	void UnbindSubscriber(SubscriberList& list, Subscriber& subscriber);
+	void CompactIfIdle(SubscriberList& list);
+	int	InvokeSubscribers(int listIndex, bool isTyped, void* arg, bool* outWasConsumed = nullptr);
+	int	InvokeNamedSubscribersWithArgs(EventID eventID, EventDelegate const& fillArgs);
+	template <typename Arg>
+	void UnsubscribeFunction(SubscriberList* list, bool (*function)(Arg));
+
+private:
+	EventSystemConfig				m_config;
+	std::vector<RegisteredEvent>	m_events; // Never shrinks, so indices stay valid while callbacks subscribe
+	std::vector<uint64_t>			m_eventTableHashes; // Open addressing, linear probing, power-of-two size; 0 = empty slot
+	std::vector<int>				m_eventTableIndices; // Index into m_events for the matching hash slot
+	mutable std::recursive_mutex	m_eventMutex;
+	MPSCQueue<QueuedEvent, &QueuedEvent::m_nextInQueue> m_queuedEvents;
+	std::vector<QueuedEvent*>		m_eventsBeingDelivered;
+	std::vector<SubscriberList>		m_typedSubscriberLists; // Indexed by GetTypedEventIndex<TEvent>()
+	std::vector<SubscriptionSlot>	m_subscriptionSlots;
+	std::vector<uint32_t>			m_freeSubscriptionSlots;
+	int								m_firingDepth = 0; // Lists are only compacted at depth 0
+	bool							m_hasUnboundSubscribers = false; // Something was unsubscribed mid-fire and awaits compaction
 };
 
 
+//------------------------------------------------------------------------------------------------
+template <typename TEvent>
+int EventSystem::GetTypedEventIndex()
+{
+	static int const s_typedEventIndex = AllocateTypedEventIndex();
+	return s_typedEventIndex;
+}
+
+template <typename Object>
+EventSubscriptionHandle EventSystem::SubscribeEventCallbackMethod(std::string const& eventName, Object* object, bool (Object::*method)(EventArgs& args))
+{
+	return AddNamedSubscriber(eventName, EventDelegate::FromMethod<EventArgs&>(object, method));
+}
+
+template <typename Callable>
+EventSubscriptionHandle EventSystem::SubscribeEventCallable(std::string const& eventName, Callable const& callable)
+{
+	return AddNamedSubscriber(eventName, EventDelegate::FromCallable<EventArgs&>(callable));
+}
+
+template <typename TEvent>
+EventSubscriptionHandle EventSystem::Subscribe(bool (*callback)(TEvent const& event))
+{
+	return AddTypedSubscriber(GetTypedEventIndex<TEvent>(), EventDelegate::FromFunction<TEvent const&>(callback));
+}
+
+template <typename TEvent, typename Object>
+EventSubscriptionHandle EventSystem::Subscribe(Object* object, bool (Object::*method)(TEvent const& event))
+{
+	return AddTypedSubscriber(GetTypedEventIndex<TEvent>(), EventDelegate::FromMethod<TEvent const&>(object, method));
+}
+
+template <typename TEvent, typename Callable>
+EventSubscriptionHandle EventSystem::SubscribeCallable(Callable const& callable)
+{
+	return AddTypedSubscriber(GetTypedEventIndex<TEvent>(), EventDelegate::FromCallable<TEvent const&>(callable));
+}
+
+template <typename TEvent>
+void EventSystem::Unsubscribe(bool (*callback)(TEvent const& event))
+{
+	std::scoped_lock lock(m_eventMutex);
+	UnsubscribeFunction(GetSubscriberList(GetTypedEventIndex<TEvent>(), true), callback);
+}
+
+template <typename Arg>
+void EventSystem::UnsubscribeFunction(SubscriberList* list, bool (*function)(Arg))
+{
+	if (list == nullptr)
+	{
+		return;
+	}
+
+	for (Subscriber& subscriber : list->m_subscribers)
+	{
+		if (subscriber.m_delegate.IsBound() && subscriber.m_delegate.IsFunction(function))
+		{
+			UnbindSubscriber(*list, subscriber);
+		}
+	}
+	CompactIfIdle(*list);
+}
+
+template <typename TEvent>
+int EventSystem::Fire(TEvent const& event, bool* outWasConsumed)
+{
+	std::scoped_lock lock(m_eventMutex);
+	return InvokeSubscribers(GetTypedEventIndex<TEvent>(), true, const_cast<TEvent*>(&event), outWasConsumed);
+}
+
+template <typename TEvent, typename FillArgs>
+int EventSystem::FireTypedAndNamed(TEvent const& event, EventID namedEventID, FillArgs const& fillArgs)
+{
+	std::scoped_lock lock(m_eventMutex);
+	bool wasConsumed = false;
+	int numCalled = InvokeSubscribers(GetTypedEventIndex<TEvent>(), true, const_cast<TEvent*>(&event), &wasConsumed);
+	if (!wasConsumed)
+	{
+		numCalled += InvokeNamedSubscribersWithArgs(namedEventID, EventDelegate::FromCallable<EventArgs&>(fillArgs));
+	}
+	return numCalled;
+}
+
+
 //------------------------------------------------------------------------------------------------
 // Standalone global-namespace helper functions; these forward to "the" event system, if it exists.
 // These give our event system a fundamental "built-in" feel in our Engine, i.e. language-like.
 // #ToDo: write these
-void SubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction* func);
+EventSubscriptionHandle SubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction* func);
 void UnsubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction* func);
 int FireEvent(std::string const& eventName, EventArgs& args);
-int FireEvent(std::string const& eventName); // Calls the above function with a temporary empty args
\ No newline at end of file
+int FireEvent(std::string const& eventName); // Calls the above function with a temporary empty args
+int FireEvent(EventID eventID, EventArgs& args);
+int FireEvent(EventID eventID);
+void QueueEvent(std::string const& eventName, EventArgs const& args);
+void QueueEvent(std::string const& eventName);
+void QueueEvent(EventID eventID, EventArgs const& args);
+void QueueEvent(EventID eventID);
\ No newline at end of file
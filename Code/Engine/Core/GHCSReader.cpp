@@ -0,0 +1,257 @@
+#include "Engine/Core/GHCSReader.hpp"
+#include "Engine/Core/BufferSchema.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/LZCompression.hpp"
+#include <stdexcept>
+
+
+//------------------------------------------------------------------------------------------------
+static bool IsFourCCAt(byte_t const* data, char const* fourCC)
+{
+	return memcmp(data, fourCC, 4) == 0;
+}
+
+
+//------------------------------------------------------------------------------------------------
+bool GhcsReader::Open(std::string const& filePath)
+{
+	Close();
+	if (!m_file.Open(filePath))
+	{
+		return Fail("Can't open \"" + filePath + "\"");
+	}
+
+	m_data = m_file.GetData();
+	m_size = m_file.GetSize();
+	return ReadHeaderAndToc();
+}
+
+bool GhcsReader::OpenBuffer(void const* data, size_t size)
+{
+	Close();
+	m_data = static_cast<byte_t const*>(data);
+	m_size = size;
+	return ReadHeaderAndToc();
+}
+
+void GhcsReader::Close()
+{
+	m_file.Close();
+	m_data = nullptr;
+	m_size = 0;
+	m_toc.clear();
+	m_errorMessage.clear();
+}
+
+bool GhcsReader::Fail(std::string const& message)
+{
+	std::string errorMessage = message;
+	Close();
+	m_errorMessage = errorMessage;
+	return false;
+}
+
+
+//------------------------------------------------------------------------------------------------
+bool GhcsReader::ReadHeaderAndToc()
+{
+	if (m_size < GHCS_FILE_HEADER_SIZE || !IsFourCCAt(m_data, "GHCS"))
+	{
+		return Fail("Not a GHCS file");
+	}
+	if (m_data[4] != GHCS_FORMAT_VERSION)
+	{
+		return Fail("Unsupported GHCS format version");
+	}
+	if (m_data[5] != GHCS_LITTLE_ENDIAN && m_data[5] != GHCS_BIG_ENDIAN)
+	{
+		return Fail("Bad GHCS endianness byte");
+	}
+	m_endianMode = (m_data[5] == GHCS_BIG_ENDIAN) ? EndianMode::BIG : EndianMode::LITTLE;
+
+	try
+	{
+		BufferParser parser(m_data, m_size, m_endianMode);
+		parser.JumpToOffset(6);
+		size_t tocOffset = parser.ParseUInt();
+		if (tocOffset < GHCS_FILE_HEADER_SIZE || tocOffset > m_size - 4 || !IsFourCCAt(m_data + tocOffset, "GTOC"))
+		{
+			return Fail("Missing GHCS table of contents");
+		}
+
+		parser.JumpToOffset(tocOffset + 4);
+		ParseSchemaValue(parser, m_toc);
+		if (parser.GetSize() - parser.GetOffset() < 4 || !IsFourCCAt(m_data + parser.GetOffset(), "ENDT"))
+		{
+			return Fail("Unterminated GHCS table of contents");
+		}
+
+		// Only the TOC's own claims are checked here; chunk contents are left untouched until asked for
+		for (TocEntry const& entry : m_toc)
+		{
+			if (entry.offset < GHCS_FILE_HEADER_SIZE || entry.offset > tocOffset || tocOffset - entry.offset < GHCS_CHUNK_HEADER_SIZE + GHCS_CHUNK_FOOTER_SIZE + static_cast<size_t>(entry.size))
+			{
+				return Fail("GHCS table of contents entry out of range");
+			}
+		}
+	}
+	catch (std::runtime_error const&)
+	{
+		return Fail("Truncated GHCS table of contents");
+	}
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------------------
+int GhcsReader::FindChunk(uint8_t chunkType, int startIndex) const
+{
+	for (int chunkIndex = startIndex; chunkIndex < GetNumChunks(); ++chunkIndex)
+	{
+		if (m_toc[chunkIndex].type == chunkType)
+		{
+			return chunkIndex;
+		}
+	}
+	return -1;
+}
+
+bool GhcsReader::IsChunkValid(int chunkIndex) const
+{
+	if (chunkIndex < 0 || chunkIndex >= GetNumChunks())
+	{
+		return false;
+	}
+
+	// ReadHeaderAndToc has already checked that header, payload and footer lie inside the file
+	TocEntry const& entry = m_toc[chunkIndex];
+	byte_t const* chunk = m_data + entry.offset;
+	if (!IsFourCCAt(chunk, "GHCK") || chunk[4] != entry.type)
+	{
+		return false;
+	}
+
+	BufferParser sizeParser(chunk + 6, 4, m_endianMode);
+	return sizeParser.ParseUInt() == entry.size && IsFourCCAt(chunk + GHCS_CHUNK_HEADER_SIZE + entry.size, "ENDC");
+}
+
+bool GhcsReader::IsChunkCompressed(int chunkIndex) const
+{
+	if (!IsChunkValid(chunkIndex))
+	{
+		throw std::runtime_error("Invalid GHCS chunk");
+	}
+	return (m_data[m_toc[chunkIndex].offset + 5] & GHCS_CHUNK_COMPRESSED_FLAG) != 0;
+}
+
+uint8_t GhcsReader::GetChunkVersion(int chunkIndex) const
+{
+	if (!IsChunkValid(chunkIndex))
+	{
+		throw std::runtime_error("Invalid GHCS chunk");
+	}
+	return static_cast<uint8_t>(m_data[m_toc[chunkIndex].offset + 5] & ~GHCS_CHUNK_COMPRESSED_FLAG);
+}
+
+std::span<byte_t const> GhcsReader::GetChunkPayload(int chunkIndex) const
+{
+	if (!IsChunkValid(chunkIndex))
+	{
+		throw std::runtime_error("Invalid GHCS chunk");
+	}
+	TocEntry const& entry = m_toc[chunkIndex];
+	return std::span<byte_t const>(m_data + entry.offset + GHCS_CHUNK_HEADER_SIZE, entry.size);
+}
+
+BufferParser GhcsReader::GetChunkParser(int chunkIndex) const
+{
+	if (IsChunkCompressed(chunkIndex))
+	{
+		throw std::runtime_error("Compressed GHCS chunk needs a decompression buffer");
+	}
+	std::span<byte_t const> payload = GetChunkPayload(chunkIndex);
+	return BufferParser(payload.data(), payload.size(), m_endianMode);
+}
+
+BufferParser GhcsReader::GetChunkParser(int chunkIndex, std::vector<byte_t>& decompressionBuffer) const
+{
+	if (!IsChunkCompressed(chunkIndex))
+	{
+		return GetChunkParser(chunkIndex);
+	}
+	if (!ReadChunk(chunkIndex, decompressionBuffer))
+	{
+		throw std::runtime_error("Corrupt compressed GHCS chunk");
+	}
+	return BufferParser(decompressionBuffer.data(), decompressionBuffer.size(), m_endianMode);
+}
+
+
+//------------------------------------------------------------------------------------------------
+bool GhcsReader::ReadChunk(int chunkIndex, std::vector<byte_t>& outPayload) const
+{
+	outPayload.clear();
+	if (!IsChunkValid(chunkIndex))
+	{
+		return false;
+	}
+
+	std::span<byte_t const> stored = GetChunkPayload(chunkIndex);
+	if (!IsChunkCompressed(chunkIndex))
+	{
+		outPayload.assign(stored.begin(), stored.end());
+		return true;
+	}
+
+	if (stored.size() < sizeof(uint32_t))
+	{
+		return false;
+	}
+	BufferParser sizeParser(stored.data(), sizeof(uint32_t), m_endianMode);
+	size_t decompressedSize = sizeParser.ParseUInt();
+	if (decompressedSize / 256 > stored.size())
+	{
+		return false; // More than any LZ stream of this length can expand to; don't trust it with an allocation
+	}
+
+	outPayload.resize(decompressedSize);
+	if (!DecompressLZ(stored.subspan(sizeof(uint32_t)), outPayload))
+	{
+		outPayload.clear();
+		return false;
+	}
+	return true;
+}
+
+bool GhcsReader::ReadChunks(std::vector<int> const& chunkIndices, std::vector<std::vector<byte_t>>& outPayloads) const
+{
+	outPayloads.resize(chunkIndices.size());
+	std::vector<uint8_t> wasRead(chunkIndices.size(), 0);
+	auto readChunk = [this, &chunkIndices, &outPayloads, &wasRead](uint32_t listIndex)
+	{
+		wasRead[listIndex] = ReadChunk(chunkIndices[listIndex], outPayloads[listIndex]);
+	};
+
+	if (g_theJobSystem != nullptr && chunkIndices.size() > 1)
+	{
+		JobCounter readCounter;
+		g_theJobSystem->EnqueueLambdaBatch((uint32_t)chunkIndices.size(), readChunk, &readCounter);
+		g_theJobSystem->WaitFor(readCounter);
+	}
+	else
+	{
+		for (uint32_t listIndex = 0; listIndex < (uint32_t)chunkIndices.size(); ++listIndex)
+		{
+			readChunk(listIndex);
+		}
+	}
+
+	for (uint8_t chunkWasRead : wasRead)
+	{
+		if (!chunkWasRead)
+		{
+			return false;
+		}
+	}
+	return true;
+}
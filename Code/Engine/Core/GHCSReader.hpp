@@ -0,0 +1,56 @@
+#pragma once
+#include "Engine/Core/GHCSWriter.hpp"
+#include "Engine/Core/BufferParser.hpp"
+#include "Engine/Core/MappedFile.hpp"
+#include <span>
+#include <string>
+#include <vector>
+
+
+//------------------------------------------------------------------------------------------------
+// Random access to a GHCS file (see GHCSWriter.hpp for the layout). Open() maps the file and reads only
+// the header and the TOC, so opening costs the same however big the chunks are; a chunk's pages are only
+// touched when GetChunkParser() hands out a parser for it. Each chunk's header and ENDC marker are
+// checked against its TOC entry on access. Chunk access is const and keeps no state, so worker threads
+// may read different chunks at once. Compressed chunks (see GHCS_CHUNK_COMPRESSED_FLAG) are decompressed
+// into caller-owned buffers; ReadChunks does a batch of them in parallel on g_theJobSystem.
+class GhcsReader
+{
+public:
+	GhcsReader() = default;
+
+	bool Open(std::string const& filePath); // False (see GetErrorMessage) if the file, its header or its TOC is bad
+	bool OpenBuffer(void const* data, size_t size); // Reads a GHCS image already in memory; the caller keeps it alive
+	void Close();
+
+	int			GetNumChunks() const { return static_cast<int>(m_toc.size()); }
+	TocEntry const& GetTocEntry(int chunkIndex) const { return m_toc[chunkIndex]; }
+	int			FindChunk(uint8_t chunkType, int startIndex = 0) const; // -1 if there is none at or after startIndex
+	EndianMode	GetEndianMode() const { return m_endianMode; }
+	std::string const& GetErrorMessage() const { return m_errorMessage; }
+
+	bool		IsChunkValid(int chunkIndex) const; // Header and ENDC marker agree with the TOC entry
+	bool		IsChunkCompressed(int chunkIndex) const; // Throws std::runtime_error if the chunk is invalid
+	uint8_t		GetChunkVersion(int chunkIndex) const; // Without the compressed flag; throws std::runtime_error if the chunk is invalid
+	std::span<byte_t const> GetChunkPayload(int chunkIndex) const; // As stored; throws std::runtime_error if the chunk is invalid
+
+	// Over the payload only, in the file's byte order. The first form is zero-copy and throws for compressed
+	// chunks; the second decompresses into decompressionBuffer when it has to.
+	BufferParser GetChunkParser(int chunkIndex) const;
+	BufferParser GetChunkParser(int chunkIndex, std::vector<byte_t>& decompressionBuffer) const;
+
+	bool		ReadChunk(int chunkIndex, std::vector<byte_t>& outPayload) const; // Decompressed copy; false if invalid or corrupt
+	bool		ReadChunks(std::vector<int> const& chunkIndices, std::vector<std::vector<byte_t>>& outPayloads) const; // In parallel; false if any fails
+
+private:
+	bool ReadHeaderAndToc();
+	bool Fail(std::string const& message);
+
+private:
+	MappedFile				m_file;
+	byte_t const*			m_data = nullptr;
+	size_t					m_size = 0;
+	EndianMode				m_endianMode = EndianMode::LITTLE;
+	std::vector<TocEntry>	m_toc;
+	std::string				m_errorMessage;
+};
@@ -0,0 +1,70 @@
+#include "Engine/Core/GHCSWriter.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/LZCompression.hpp"
+
+
+//------------------------------------------------------------------------------------------------
+// False if compression doesn't pay for itself, in which case the chunk is stored raw
+static bool CompressGhcsPayload(std::vector<byte_t> const& payload, EndianMode mode, std::vector<byte_t>& outStored)
+{
+	outStored.clear();
+	BufferWriter sizeWriter(outStored, mode);
+	sizeWriter.AppendUInt((uint32_t)payload.size());
+	CompressLZ(payload, outStored);
+	return outStored.size() < payload.size();
+}
+
+static TocEntry AppendGhcsChunkBytes(BufferWriter& w, std::vector<byte_t>& buffer, GhcsChunkData const& chunk, bool isCompressed, std::vector<byte_t> const& storedPayload)
+{
+	GhcsChunkPatch patch = BeginGhcsChunk(w, buffer, chunk.m_type, chunk.m_version);
+	if (isCompressed)
+	{
+		buffer[patch.chunkStartOffset + 5] |= GHCS_CHUNK_COMPRESSED_FLAG; // The version byte
+	}
+	w.AppendArray(storedPayload);
+	return EndGhcsChunk(w, buffer, patch);
+}
+
+
+//------------------------------------------------------------------------------------------------
+TocEntry AppendGhcsChunk(BufferWriter& w, std::vector<byte_t>& buffer, GhcsChunkData const& chunk)
+{
+	std::vector<byte_t> compressed;
+	if (chunk.m_compress && CompressGhcsPayload(chunk.m_payload, w.GetEndianMode(), compressed))
+	{
+		return AppendGhcsChunkBytes(w, buffer, chunk, true, compressed);
+	}
+	return AppendGhcsChunkBytes(w, buffer, chunk, false, chunk.m_payload);
+}
+
+void AppendGhcsChunks(BufferWriter& w, std::vector<byte_t>& buffer, std::vector<GhcsChunkData> const& chunks, std::vector<TocEntry>& toc)
+{
+	EndianMode mode = w.GetEndianMode();
+	std::vector<std::vector<byte_t>> compressed(chunks.size());
+	std::vector<uint8_t> isCompressed(chunks.size(), 0);
+	auto compressChunk = [&chunks, &compressed, &isCompressed, mode](uint32_t chunkIndex)
+	{
+		GhcsChunkData const& chunk = chunks[chunkIndex];
+		isCompressed[chunkIndex] = chunk.m_compress && CompressGhcsPayload(chunk.m_payload, mode, compressed[chunkIndex]);
+	};
+
+	if (g_theJobSystem != nullptr && chunks.size() > 1)
+	{
+		JobCounter compressCounter;
+		g_theJobSystem->EnqueueLambdaBatch((uint32_t)chunks.size(), compressChunk, &compressCounter);
+		g_theJobSystem->WaitFor(compressCounter);
+	}
+	else
+	{
+		for (uint32_t chunkIndex = 0; chunkIndex < (uint32_t)chunks.size(); ++chunkIndex)
+		{
+			compressChunk(chunkIndex);
+		}
+	}
+
+	for (size_t chunkIndex = 0; chunkIndex < chunks.size(); ++chunkIndex)
+	{
+		bool chunkIsCompressed = isCompressed[chunkIndex] != 0;
+		toc.push_back(AppendGhcsChunkBytes(w, buffer, chunks[chunkIndex], chunkIsCompressed, chunkIsCompressed ? compressed[chunkIndex] : chunks[chunkIndex].m_payload));
+	}
+}
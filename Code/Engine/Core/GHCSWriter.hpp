@@ -2,11 +2,30 @@
 #include <vector>
 #include <cstdint>
 #include "Engine/Core/BufferWriter.hpp"
+#include "Engine/Core/BufferSchema.hpp"
+
+//------------------------------------------------------------------------------------------------
+// File layout:
+//	header	"GHCS", format version (u8), endianness (u8: 1 little, 2 big), TOC offset (u32)
+//	chunks	"GHCK", type (u8), version (u8), payload size (u32), payload, "ENDC"
+//			If the version's top bit (GHCS_CHUNK_COMPRESSED_FLAG) is set, the payload is the uncompressed size
+//			(u32) followed by a CompressLZ stream, and the TOC and header sizes are the stored size.
+//	TOC		"GTOC", entry count (u32), entries (type u8, chunk offset u32, payload size u32), "ENDT"
+// Everything after the endianness byte is in the byte order it names.
+constexpr uint8_t GHCS_FORMAT_VERSION = 1;
+constexpr size_t GHCS_FILE_HEADER_SIZE = 10;
+constexpr size_t GHCS_CHUNK_HEADER_SIZE = 10;
+constexpr size_t GHCS_CHUNK_FOOTER_SIZE = 4;
+constexpr uint8_t GHCS_LITTLE_ENDIAN = 1;
+constexpr uint8_t GHCS_BIG_ENDIAN = 2;
+constexpr uint8_t GHCS_CHUNK_COMPRESSED_FLAG = 0x80; // So chunk versions run 0..127
 
 struct GhcsChunkPatch
 {
 	size_t sizeFieldOffset = 0;
 	size_t payloadStartOffset = 0;
+	size_t chunkStartOffset = 0;
+	uint8_t chunkType = 0;
 };
 
 struct TocEntry
@@ -16,6 +35,16 @@ struct TocEntry
 	uint32_t size;
 };
 
+template <>
+struct BufferSchema<TocEntry>
+{
+	static constexpr uint32_t VERSION = 0;
+	static constexpr auto FIELDS = std::make_tuple(
+		MakeBufferSchemaField(&TocEntry::type),
+		MakeBufferSchemaField(&TocEntry::offset),
+		MakeBufferSchemaField(&TocEntry::size));
+};
+
 inline void AppendFourCC(BufferWriter& w, char const* fourcc)
 {
 	w.AppendChar(fourcc[0]);
@@ -24,9 +53,35 @@ inline void AppendFourCC(BufferWriter& w, char const* fourcc)
 	w.AppendChar(fourcc[3]);
 }
 
+// Returns the offset of the TOC offset field, for EndGhcsFile
+inline size_t BeginGhcsFile(BufferWriter& w, std::vector<byte_t>& buffer)
+{
+	AppendFourCC(w, "GHCS");
+	w.AppendByte(GHCS_FORMAT_VERSION);
+	w.AppendByte(w.GetEndianMode() == EndianMode::BIG ? GHCS_BIG_ENDIAN : GHCS_LITTLE_ENDIAN);
+
+	size_t tocOffsetField = buffer.size();
+	w.AppendUInt(0);
+	return tocOffsetField;
+}
+
+inline void EndGhcsFile(BufferWriter& w, std::vector<byte_t>& buffer, size_t tocOffsetField, std::vector<TocEntry> const& toc)
+{
+	w.OverwriteUInt32At(tocOffsetField, (uint32_t)buffer.size());
+
+	AppendFourCC(w, "GTOC");
+	AppendSchemaValue(w, toc);
+	AppendFourCC(w, "ENDT");
+}
+
+// chunkVer must be below 128; the top bit is reserved for GHCS_CHUNK_COMPRESSED_FLAG
 inline GhcsChunkPatch BeginGhcsChunk(BufferWriter& w, std::vector<byte_t>& buffer, uint8_t chunkType, uint8_t chunkVer = 0)
 {
+	GUARANTEE_OR_DIE((chunkVer & GHCS_CHUNK_COMPRESSED_FLAG) == 0, "GHCS chunk versions must be below 128");
+
 	GhcsChunkPatch patch;
+	patch.chunkStartOffset = buffer.size();
+	patch.chunkType = chunkType;
 
 	AppendFourCC(w, "GHCK");
 
@@ -40,7 +95,8 @@ inline GhcsChunkPatch BeginGhcsChunk(BufferWriter& w, std::vector<byte_t>& buffe
 	return patch;
 }
 
-inline void EndGhcsChunk(BufferWriter& w, std::vector<byte_t>& buffer, GhcsChunkPatch const& patch)
+// Returns the chunk's TOC entry
+inline TocEntry EndGhcsChunk(BufferWriter& w, std::vector<byte_t>& buffer, GhcsChunkPatch const& patch)
 {
 	size_t payloadEnd = buffer.size();
 	uint32_t payloadSize = (uint32_t)(payloadEnd - patch.payloadStartOffset);
@@ -48,4 +104,27 @@ inline void EndGhcsChunk(BufferWriter& w, std::vector<byte_t>& buffer, GhcsChunk
 	w.OverwriteUInt32At(patch.sizeFieldOffset, payloadSize);
 
 	AppendFourCC(w, "ENDC");
-}
\ No newline at end of file
+
+	TocEntry entry;
+	entry.type = patch.chunkType;
+	entry.offset = (uint32_t)patch.chunkStartOffset;
+	entry.size = payloadSize;
+	return entry;
+}
+
+
+//------------------------------------------------------------------------------------------------
+// A whole chunk payload built up front, for writers that want compression
+struct GhcsChunkData
+{
+	uint8_t				m_type = 0;
+	uint8_t				m_version = 0; // 0..127
+	std::vector<byte_t>	m_payload; // Already serialized in the file's byte order
+	bool				m_compress = false; // Stored raw anyway if compressing doesn't make it smaller
+};
+
+TocEntry AppendGhcsChunk(BufferWriter& w, std::vector<byte_t>& buffer, GhcsChunkData const& chunk);
+
+// Compresses the chunks in parallel on g_theJobSystem (inline if there isn't one), then appends them in
+// order and adds their entries to toc
+void AppendGhcsChunks(BufferWriter& w, std::vector<byte_t>& buffer, std::vector<GhcsChunkData> const& chunks, std::vector<TocEntry>& toc);
@@ -1,13 +1,273 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 #include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Input/NamedStrings.hpp"
 #include <algorithm>
 #include <cassert>
 
+extern EventSystem* g_theEventSystem;
+
+// Defined here rather than by the game so that ParallelFor's default argument, and the engine utilities
+// built on it, link whether or not the game creates a job system; without one they simply run inline
+JobSystem* g_theJobSystem = nullptr;
+
+static thread_local JobSystem* s_workerOwner = nullptr;
+static thread_local uint32_t   s_workerIndex = 0;
+static thread_local JobSystem* s_traceOwner = nullptr; // Set on CPU and I/O workers alike
+static thread_local JobTraceBuffer* s_traceBuffer = nullptr;
+
+constexpr size_t JOB_TRACE_FRAME_HISTORY = 256;
+
+
+//------------------------------------------------------------------------------------------------
+// Tells the core we're busy-waiting so it can save power and let a hyperthread sibling run
+static void CpuRelax()
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	_mm_pause();
+#else
+	std::this_thread::yield();
+#endif
+}
+
+// Bit i of coreMask allows core i; returns false where affinity isn't supported or the mask was rejected
+static bool SetThreadCoreMask(std::thread::native_handle_type thread, uint64_t coreMask)
+{
+#ifdef _WIN32
+	return SetThreadAffinityMask(thread, static_cast<DWORD_PTR>(coreMask)) != 0;
+#elif defined(__linux__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	for (int core = 0; core < 64 && core < CPU_SETSIZE; ++core)
+	{
+		if (coreMask & (1ull << core))
+		{
+			CPU_SET(core, &cpuSet);
+		}
+	}
+	return pthread_setaffinity_np(thread, sizeof(cpuSet), &cpuSet) == 0;
+#else
+	(void)thread;
+	(void)coreMask;
+	return false;
+#endif
+}
+
+static std::thread::native_handle_type GetCurrentThreadNativeHandle()
+{
+#ifdef _WIN32
+	return GetCurrentThread();
+#else
+	return pthread_self();
+#endif
+}
+
+
+//------------------------------------------------------------------------------------------------
+// Hands the loaded bytes to the caller's callback on a CPU worker
+struct FileLoadedJob : public Job
+{
+	FileLoadedJob(FileLoadedCallback const& onLoaded)
+		: m_onLoaded(onLoaded)
+	{
+		m_retrieveWhenComplete = false;
+	}
+
+	void Execute() override { m_onLoaded(m_fileBuffer, m_wasRead); }
+
+	FileLoadedCallback		m_onLoaded;
+	std::vector<uint8_t>	m_fileBuffer;
+	bool					m_wasRead = false;
+};
+
+
+//------------------------------------------------------------------------------------------------
+// Runs on an I/O thread; only does the blocking read, then passes the buffer to the CPU side
+struct FileReadJob : public Job
+{
+	FileReadJob(JobSystem& jobSystem, std::string const& filePath, FileLoadedCallback const& onLoaded, JobCounter* signalOnLoaded, JobOptions const& options)
+		: m_jobSystem(jobSystem), m_filePath(filePath), m_onLoaded(onLoaded), m_signalOnLoaded(signalOnLoaded), m_options(options)
+	{
+		m_retrieveWhenComplete = false;
+		SetOptions(options);
+	}
+
+	void Execute() override
+	{
+		FileLoadedJob* loadedJob = new FileLoadedJob(m_onLoaded);
+		loadedJob->SetOptions(m_options);
+		loadedJob->m_wasRead = FileReadToBuffer(loadedJob->m_fileBuffer, m_filePath) >= 0;
+		m_jobSystem.Enqueue(loadedJob, m_signalOnLoaded);
+	}
+
+	JobSystem&			m_jobSystem;
+	std::string			m_filePath;
+	FileLoadedCallback	m_onLoaded;
+	JobCounter*			m_signalOnLoaded = nullptr;
+	JobOptions			m_options;
+};
+
+
+//------------------------------------------------------------------------------------------------
+JobPool::JobPool(uint32_t capacity)
+	: m_capacity(capacity)
+	, m_slots(std::make_unique<LambdaJob[]>(capacity))
+	, m_nextFreeIndex(std::make_unique<std::atomic<uint32_t>[]>(capacity))
+	, m_freeHead(capacity > 0 ? 0 : INVALID_INDEX)
+{
+	for (uint32_t i = 0; i < capacity; ++i)
+	{
+		m_slots[i].m_ownerPool = this;
+		m_slots[i].m_poolIndex = i;
+		m_nextFreeIndex[i].store((i + 1 < capacity) ? i + 1 : INVALID_INDEX);
+	}
+}
+
+LambdaJob* JobPool::Acquire()
+{
+	uint64_t head = m_freeHead.load();
+	while (true)
+	{
+		uint32_t index = static_cast<uint32_t>(head);
+		if (index == INVALID_INDEX)
+		{
+			return nullptr;
+		}
+
+		uint64_t tag = (head >> 32) + 1;
+		uint64_t newHead = (tag << 32) | m_nextFreeIndex[index].load();
+		if (m_freeHead.compare_exchange_weak(head, newHead))
+		{
+			return &m_slots[index];
+		}
+	}
+}
+
+void JobPool::Release(LambdaJob* job)
+{
+	job->DestroyCallable();
+	job->SetOptions(JobOptions());
+
+	uint32_t index = job->m_poolIndex;
+	uint64_t head = m_freeHead.load();
+	while (true)
+	{
+		m_nextFreeIndex[index].store(static_cast<uint32_t>(head));
+		uint64_t tag = (head >> 32) + 1;
+		uint64_t newHead = (tag << 32) | index;
+		if (m_freeHead.compare_exchange_weak(head, newHead))
+		{
+			return;
+		}
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+void JobWorkerQueue::Push(Job* job)
+{
+	std::scoped_lock<std::mutex> g(m_mutex);
+	m_jobs[static_cast<int>(job->m_priority)].push_back(job);
+}
+
+void JobWorkerQueue::PushRange(Job* const* jobs, size_t count)
+{
+	std::scoped_lock<std::mutex> g(m_mutex);
+	for (size_t i = 0; i < count; ++i)
+	{
+		m_jobs[static_cast<int>(jobs[i]->m_priority)].push_back(jobs[i]);
+	}
+}
+
+Job* JobWorkerQueue::Pop(JobPriority priority)
+{
+	std::scoped_lock<std::mutex> g(m_mutex);
+	std::deque<Job*>& lane = m_jobs[static_cast<int>(priority)];
+	if (lane.empty()) return nullptr;
+
+	Job* job = lane.back();
+	lane.pop_back();
+	return job;
+}
+
+Job* JobWorkerQueue::Steal(JobPriority priority)
+{
+	std::unique_lock<std::mutex> g(m_mutex, std::try_to_lock);
+	std::deque<Job*>& lane = m_jobs[static_cast<int>(priority)];
+	if (!g.owns_lock() || lane.empty()) return nullptr;
+
+	Job* job = lane.front();
+	lane.pop_front();
+	return job;
+}
+
+void JobWorkerQueue::DrainTo(std::vector<Job*>& out)
+{
+	std::scoped_lock<std::mutex> g(m_mutex);
+	for (std::deque<Job*>& lane : m_jobs)
+	{
+		out.insert(out.end(), lane.begin(), lane.end());
+		lane.clear();
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
 JobSystem::JobSystem(const JobSystemConfig& cfg)
-	: m_running(false)
-	, m_maxExecuting(1)
-	, m_config(cfg)
+	: m_config(cfg)
+	, m_running(false)
+	, m_numQueuedJobs(0)
+	, m_numSleepingWorkers(0)
+	, m_nextQueueIndex(0)
 {
+	uint32_t hc = std::max(1u, std::thread::hardware_concurrency());
+	m_workerCount = m_config.m_workerCount ? m_config.m_workerCount
+		: (hc > 1 ? hc - 1 : 1);
+
+	// Each worker runs one job at a time, so capping the worker count caps concurrent execution
+	if (m_config.m_maxExecuting != 0)
+	{
+		m_workerCount = std::min(m_workerCount, m_config.m_maxExecuting);
+	}
 
+	m_fileIOWorkerCount = m_config.m_fileIOWorkerCount ? m_config.m_fileIOWorkerCount : 1;
+	m_jobPool = std::make_unique<JobPool>(m_config.m_pooledJobCapacity);
+
+	m_queues.reserve(m_workerCount);
+	for (uint32_t i = 0; i < m_workerCount; ++i)
+	{
+		m_queues.push_back(std::make_unique<JobWorkerQueue>());
+	}
+
+	if (m_config.m_enableTracing)
+	{
+		m_traceBuffers.push_back(std::make_unique<JobTraceBuffer>("Main", m_config.m_traceEventsPerThread));
+		for (uint32_t i = 0; i < m_workerCount; ++i)
+		{
+			m_traceBuffers.push_back(std::make_unique<JobTraceBuffer>(Stringf("Worker %u", i), m_config.m_traceEventsPerThread));
+		}
+		for (uint32_t i = 0; i < m_fileIOWorkerCount; ++i)
+		{
+			m_traceBuffers.push_back(std::make_unique<JobTraceBuffer>(Stringf("File I/O %u", i), m_config.m_traceEventsPerThread));
+		}
+		m_frameStartTimes.resize(JOB_TRACE_FRAME_HISTORY, 0.0);
+	}
 }
 
 void JobSystem::Startup()
@@ -15,93 +275,558 @@ void JobSystem::Startup()
 	if (m_running.load()) return;
 
 	m_running.store(true);
+	m_mainThreadID = std::this_thread::get_id();
 
-	uint32_t hc = std::max(1u, std::thread::hardware_concurrency());
-	uint32_t workerCount = m_config.m_workerCount ? m_config.m_workerCount
-		: (hc > 1 ? hc - 1 : 1);
+	m_workers.reserve(m_workerCount);
+	for (uint32_t i = 0; i < m_workerCount; ++i)
+	{
+		m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+	ApplyCoreAffinity();
 
-	m_maxExecuting = (m_config.m_maxExecuting != 0) ? m_config.m_maxExecuting
-		: static_cast<size_t>(workerCount);
+	// Only "the" job system owns console commands; temporary systems (e.g. the benchmark's) stay quiet
+	if (this == g_theJobSystem && g_theEventSystem)
+	{
+		g_theEventSystem->SubscribeEventCallbackFunction("JobBenchmark", JobSystem::Command_JobBenchmark);
+		g_theEventSystem->SubscribeEventCallbackFunction("JobTrace", JobSystem::Command_JobTrace);
+	}
 
-	m_workers.reserve(workerCount);
-	for (uint32_t i = 0; i < workerCount; ++i) 
 	{
-		m_workers.emplace_back(&JobSystem::WorkerLoop, this);
+		std::scoped_lock<std::mutex> g(m_fileIOMutex);
+		m_fileIORunning = true;
+	}
+	m_fileIOWorkers.reserve(m_fileIOWorkerCount);
+	for (uint32_t i = 0; i < m_fileIOWorkerCount; ++i)
+	{
+		m_fileIOWorkers.emplace_back(&JobSystem::FileIOWorkerLoop, this, i);
 	}
 }
 
-void JobSystem::Enqueue(Job* j)
+void JobSystem::Enqueue(Job* j, JobCounter* signalOnComplete)
 {
 	assert(j != nullptr);
+
+	j->m_signalOnComplete = signalOnComplete;
+	if (signalOnComplete)
+	{
+		signalOnComplete->m_value.fetch_add(1);
+	}
+
+	Schedule(&j, 1);
+}
+
+void JobSystem::EnqueueBatch(Job* const* jobs, size_t count, JobCounter* signalOnComplete)
+{
+	if (count == 0) return;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		jobs[i]->m_signalOnComplete = signalOnComplete;
+	}
+	if (signalOnComplete)
+	{
+		signalOnComplete->m_value.fetch_add(static_cast<int>(count));
+	}
+
+	Schedule(jobs, count);
+}
+
+void JobSystem::EnqueueBatch(std::vector<Job*> const& jobs, JobCounter* signalOnComplete)
+{
+	EnqueueBatch(jobs.data(), jobs.size(), signalOnComplete);
+}
+
+void JobSystem::EnqueueAfter(Job* j, JobCounter& dependency, JobCounter* signalOnComplete)
+{
+	EnqueueAfter(j, { &dependency }, signalOnComplete);
+}
+
+void JobSystem::EnqueueAfter(Job* j, std::initializer_list<JobCounter*> dependencies, JobCounter* signalOnComplete)
+{
+	assert(j != nullptr);
+
+	j->m_signalOnComplete = signalOnComplete;
+	if (signalOnComplete)
+	{
+		signalOnComplete->m_value.fetch_add(1);
+	}
+
+	// The extra count keeps the job from launching while it is still being registered
+	j->m_numUnfinishedDependencies.store(static_cast<int>(dependencies.size()) + 1);
+
+	for (JobCounter* dependency : dependencies)
+	{
+		bool isWaiting = false;
+		{
+			std::scoped_lock<std::mutex> g(dependency->m_waitingJobsMutex);
+			if (dependency->m_value.load() > 0)
+			{
+				dependency->m_waitingJobs.push_back(j);
+				isWaiting = true;
+			}
+		}
+		if (!isWaiting)
+		{
+			j->m_numUnfinishedDependencies.fetch_sub(1);
+		}
+	}
+
+	if (j->m_numUnfinishedDependencies.fetch_sub(1) == 1)
+	{
+		Schedule(&j, 1);
+	}
+}
+
+void JobSystem::EnqueueMainThread(Job* j, JobCounter* signalOnComplete)
+{
+	assert(j != nullptr);
+
+	j->m_signalOnComplete = signalOnComplete;
+	if (signalOnComplete)
+	{
+		signalOnComplete->m_value.fetch_add(1);
+	}
+
+	StampEnqueueTime(&j, 1);
+	m_mainThreadJobs.Push(j);
+}
+
+void JobSystem::ExecuteMainThreadJobs()
+{
+	assert(IsMainThread());
+
+	// Only run what was queued before this call; jobs queued while running wait for the next one
+	std::vector<Job*> jobs;
+	m_mainThreadJobs.PopMany(jobs);
+	for (Job* job : jobs)
+	{
+		ExecuteJob(job);
+	}
+}
+
+void JobSystem::BeginFrame()
+{
+	if (!m_frameStartTimes.empty())
+	{
+		m_frameStartTimes[m_frameNumber % m_frameStartTimes.size()] = GetCurrentTimeSeconds();
+		++m_frameNumber;
+	}
+
+	ExecuteMainThreadJobs();
+}
+
+void JobSystem::IncrementCounter(JobCounter& counter)
+{
+	counter.m_value.fetch_add(1);
+}
+
+void JobSystem::DecrementCounter(JobCounter& counter)
+{
+	std::vector<Job*> readyJobs;
+	SignalCounter(&counter, readyJobs);
+	if (!readyJobs.empty())
+	{
+		Schedule(readyJobs.data(), readyJobs.size());
+	}
+}
+
+bool JobSystem::IsWorkerThread() const
+{
+	return s_workerOwner == this;
+}
+
+void JobSystem::WaitFor(JobCounter& counter, bool runMainThreadJobs)
+{
+	const bool helpMainThread = runMainThreadJobs && IsMainThread();
+	while (!counter.IsDone())
+	{
+		Job* job = helpMainThread ? m_mainThreadJobs.Pop() : nullptr;
+		if (job == nullptr)
+		{
+			job = (s_workerOwner == this) ? FindJob(s_workerIndex) : StealJob();
+		}
+		if (job)
+		{
+			ExecuteJob(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// The last signaller may still be releasing waiters; don't let the caller destroy the counter under it
+	std::scoped_lock<std::mutex> g(counter.m_waitingJobsMutex);
+}
+
+void JobSystem::EnqueueFileIO(Job* j, JobCounter* signalOnComplete)
+{
+	assert(j != nullptr);
+
+	j->m_signalOnComplete = signalOnComplete;
+	if (signalOnComplete)
+	{
+		signalOnComplete->m_value.fetch_add(1);
+	}
+
+	StampEnqueueTime(&j, 1);
+	{
+		std::scoped_lock<std::mutex> g(m_fileIOMutex);
+		m_fileIOQueues[static_cast<int>(j->m_priority)].push_back(j);
+	}
+	m_fileIOCV.notify_one();
+}
+
+void JobSystem::ReadFileAsync(std::string const& filePath, FileLoadedCallback const& onLoaded, JobCounter* signalOnComplete, JobOptions const& options)
+{
+	// The read job re-enqueues against the same counter before it signals, so the counter covers both halves
+	EnqueueFileIO(new FileReadJob(*this, filePath, onLoaded, signalOnComplete, options), signalOnComplete);
+}
+
+void JobSystem::Schedule(Job* const* jobs, size_t count)
+{
+	StampEnqueueTime(jobs, count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		m_numQueuedJobsByPriority[static_cast<int>(jobs[i]->m_priority)].fetch_add(1);
+	}
+	m_numQueuedJobs.fetch_add(static_cast<int64_t>(count));
+
+	// Jobs spawned from inside a job stay on that worker's deque; others are dealt round-robin
+	uint32_t queueIndex = GetCurrentWorkerIndex();
+	if (count == 1)
 	{
-		std::scoped_lock<std::mutex> g(m_mutex);
-		m_pending.push_back(j);
+		m_queues[queueIndex]->Push(jobs[0]);
+	}
+	else
+	{
+		const size_t numQueues = m_queues.size();
+		const size_t perQueue = (count + numQueues - 1) / numQueues;
+		for (size_t first = 0; first < count; first += perQueue)
+		{
+			size_t n = std::min(perQueue, count - first);
+			m_queues[queueIndex]->PushRange(jobs + first, n);
+			queueIndex = (queueIndex + 1) % static_cast<uint32_t>(numQueues);
+		}
+	}
+
+	WakeWorkers(count);
+}
+
+void JobSystem::SignalCounter(JobCounter* counter, std::vector<Job*>& outReadyJobs)
+{
+	int value = counter->m_value.load();
+	while (value > 1)
+	{
+		if (counter->m_value.compare_exchange_weak(value, value - 1)) return;
+	}
+
+	// The final decrement happens under the lock so waiters and registrations see it atomically
+	std::vector<Job*> waitingJobs;
+	{
+		std::scoped_lock<std::mutex> g(counter->m_waitingJobsMutex);
+		if (counter->m_value.fetch_sub(1) == 1)
+		{
+			waitingJobs.swap(counter->m_waitingJobs);
+		}
+	}
+
+	for (Job* waitingJob : waitingJobs)
+	{
+		if (waitingJob->m_numUnfinishedDependencies.fetch_sub(1) == 1)
+		{
+			outReadyJobs.push_back(waitingJob);
+		}
 	}
-	m_cv.notify_one();
 }
 
 void JobSystem::RetrieveCompleted(std::vector<Job*>& out, size_t maxCount)
 {
-	std::scoped_lock<std::mutex> g(m_mutex);
+	std::scoped_lock<std::mutex> g(m_retrieveMutex);
+	m_completed.PopMany(out, maxCount);
+}
+
+void JobSystem::ApplyCoreAffinity()
+{
+	// Masks are 64 bits wide; machines with more cores simply don't get pinned past the first 64
+	const uint32_t numCores = std::min(64u, std::max(1u, std::thread::hardware_concurrency()));
+	const bool reserveMainCore = m_config.m_reserveMainThreadCore && numCores > 1;
+	if (!m_config.m_pinWorkersToCores && !reserveMainCore) return;
 
-	const size_t nAvail = m_completed.size();
-	const size_t n = (maxCount == 0) ? nAvail : std::min(maxCount, nAvail);
+	const uint32_t firstWorkerCore = reserveMainCore ? 1 : 0;
+	const uint32_t numWorkerCores = numCores - firstWorkerCore;
+	const uint64_t allCoresMask = (numCores == 64) ? ~0ull : ((1ull << numCores) - 1);
+	const uint64_t workerCoresMask = reserveMainCore ? (allCoresMask & ~1ull) : allCoresMask;
 
-	out.reserve(out.size() + n);
-	for (size_t i = 0; i < n; ++i) 
+	if (reserveMainCore)
 	{
-		out.push_back(m_completed[i]);
+		SetThreadCoreMask(GetCurrentThreadNativeHandle(), 1ull);
 	}
-	if (n > 0) 
+
+	for (uint32_t i = 0; i < m_workers.size(); ++i)
 	{
-		m_completed.erase(m_completed.begin(), m_completed.begin() + static_cast<long>(n));
-		m_cv.notify_all();
+		uint64_t coreMask = workerCoresMask;
+		if (m_config.m_pinWorkersToCores)
+		{
+			coreMask = 1ull << (firstWorkerCore + (i % numWorkerCores));
+		}
+		SetThreadCoreMask(m_workers[i].native_handle(), coreMask);
 	}
 }
 
-void JobSystem::WorkerLoop()
+void JobSystem::WorkerLoop(uint32_t workerIndex)
 {
-	while(true)
+	s_workerOwner = this;
+	s_workerIndex = workerIndex;
+	s_traceOwner = this;
+	s_traceBuffer = m_traceBuffers.empty() ? nullptr : m_traceBuffers[1 + workerIndex].get();
+
+	const uint32_t numSpinRounds = m_config.m_idleSpinCount;
+	const uint32_t numIdleRounds = m_config.m_idleSpinCount + m_config.m_idleYieldCount;
+	uint32_t idleRound = 0;
+
+	while (true)
 	{
-		Job* job = nullptr;
+		Job* job = FindJob(workerIndex);
+		if (job)
+		{
+			ExecuteJob(job);
+			idleRound = 0;
+			continue;
+		}
+
+		// Polling FindJob is a couple of relaxed loads while the system is empty, so spinning stays cheap
+		if (idleRound < numIdleRounds && m_running.load())
+		{
+			if (idleRound < numSpinRounds)
+			{
+				CpuRelax();
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+			++idleRound;
+			continue;
+		}
+		idleRound = 0;
 
+		std::unique_lock<std::mutex> lk(m_sleepMutex);
+		if (!m_running.load() && m_numQueuedJobs.load() <= 0)
 		{
-			std::unique_lock<std::mutex> lk(m_mutex);
-			m_cv.wait(lk, [this] {
-				return !m_running.load() || !m_pending.empty();
+			return;
+		}
+
+		m_numSleepingWorkers.fetch_add(1);
+		m_sleepCV.wait(lk, [this] {
+			return !m_running.load() || m_numQueuedJobs.load() > 0;
+			});
+		m_numSleepingWorkers.fetch_sub(1);
+	}
+}
+
+void JobSystem::FileIOWorkerLoop(uint32_t fileIOWorkerIndex)
+{
+	s_traceOwner = this;
+	s_traceBuffer = m_traceBuffers.empty() ? nullptr : m_traceBuffers[1 + m_workerCount + fileIOWorkerIndex].get();
+
+	while (true)
+	{
+		Job* job = nullptr;
+		{
+			std::unique_lock<std::mutex> lk(m_fileIOMutex);
+			auto hasQueuedReads = [this]() {
+				for (std::deque<Job*> const& lane : m_fileIOQueues)
+				{
+					if (!lane.empty()) return true;
+				}
+				return false;
+			};
+			m_fileIOCV.wait(lk, [this, &hasQueuedReads] {
+				return !m_fileIORunning || hasQueuedReads();
 				});
 
-			if (!m_running.load() && m_pending.empty() && m_executing.empty()) 
+			if (!hasQueuedReads())
 			{
 				return;
 			}
 
-			if (!m_pending.empty() && m_executing.size() < m_maxExecuting) 
+			for (std::deque<Job*>& lane : m_fileIOQueues)
 			{
-				job = m_pending.back();
-				m_pending.pop_back();
-				m_executing.push_back(job);
-			}
-			else {
-				continue;
+				if (!lane.empty())
+				{
+					job = lane.front();
+					lane.pop_front();
+					break;
+				}
 			}
 		}
 
-		if (job) 
+		ExecuteJob(job);
+	}
+}
+
+Job* JobSystem::StealJob()
+{
+	if (m_numQueuedJobs.load() <= 0) return nullptr;
+
+	for (int priority = 0; priority < NUM_JOB_PRIORITIES; ++priority)
+	{
+		Job* job = TakeQueuedJob(static_cast<JobPriority>(priority), 0, false);
+		if (job) return job;
+	}
+	return nullptr;
+}
+
+Job* JobSystem::FindJob(uint32_t workerIndex)
+{
+	if (m_numQueuedJobs.load() <= 0) return nullptr;
+
+	// An urgent job on another worker's deque beats a less urgent one on our own
+	for (int priority = 0; priority < NUM_JOB_PRIORITIES; ++priority)
+	{
+		Job* job = TakeQueuedJob(static_cast<JobPriority>(priority), workerIndex, true);
+		if (job) return job;
+	}
+	return nullptr;
+}
+
+Job* JobSystem::TakeQueuedJob(JobPriority priority, uint32_t firstQueueIndex, bool popFirstQueue)
+{
+	std::atomic<int64_t>& numQueuedInLane = m_numQueuedJobsByPriority[static_cast<int>(priority)];
+	if (numQueuedInLane.load() <= 0) return nullptr;
+
+	const uint32_t numQueues = static_cast<uint32_t>(m_queues.size());
+	Job* job = popFirstQueue ? m_queues[firstQueueIndex]->Pop(priority) : nullptr;
+	for (uint32_t i = popFirstQueue ? 1 : 0; job == nullptr && i < numQueues; ++i)
+	{
+		job = m_queues[(firstQueueIndex + i) % numQueues]->Steal(priority);
+	}
+
+	if (job)
+	{
+		numQueuedInLane.fetch_sub(1);
+		m_numQueuedJobs.fetch_sub(1);
+	}
+	return job;
+}
+
+void JobSystem::ExecuteJob(Job* job)
+{
+	// Cancelled and expired jobs are dropped here rather than searched for in the queues, so cancelling is O(1)
+	bool isSkipped = job->IsCancelled() || (job->m_deadlineSeconds > 0.0 && GetCurrentTimeSeconds() > job->m_deadlineSeconds);
+	if (!isSkipped)
+	{
+		JobTraceBuffer* traceBuffer = GetCurrentTraceBuffer();
+		if (traceBuffer)
 		{
+			JobTraceEvent traceEvent;
+			traceEvent.m_name = job->m_name;
+			traceEvent.m_enqueueSeconds = job->m_enqueueSeconds;
+			traceEvent.m_startSeconds = GetCurrentTimeSeconds();
 			job->Execute();
+			traceEvent.m_endSeconds = GetCurrentTimeSeconds();
+			traceBuffer->Record(traceEvent);
 		}
-
+		else
 		{
-			std::scoped_lock<std::mutex> g(m_mutex);
-			auto it = std::find(m_executing.begin(), m_executing.end(), job);
-			if (it != m_executing.end()) {
-				m_executing.erase(it);
-			}
-			m_completed.push_back(job);
+			job->Execute();
 		}
+	}
+
+	// Once published the job may be deleted by its owner at any moment, so read it first
+	JobCounter* counter = job->m_signalOnComplete;
+	if (job->m_retrieveWhenComplete && !isSkipped)
+	{
+		m_completed.Push(job);
+	}
+	else
+	{
+		DisposeJob(job);
+	}
+
+	if (counter)
+	{
+		DecrementCounter(*counter);
+	}
+}
+
+void JobSystem::DisposeJob(Job* job)
+{
+	if (job->m_ownerPool)
+	{
+		job->m_ownerPool->Release(static_cast<LambdaJob*>(job));
+	}
+	else
+	{
+		delete job;
+	}
+}
+
+LambdaJob* JobSystem::AcquireLambdaJob()
+{
+	LambdaJob* job = m_jobPool->Acquire();
+	if (job == nullptr)
+	{
+		job = new LambdaJob();
+	}
+	return job;
+}
+
+void JobSystem::WakeWorkers(size_t numNewJobs)
+{
+	if (m_numSleepingWorkers.load() == 0) return;
 
-		m_cv.notify_all();
+	// Taking the lock orders this wake-up after any worker that is between its predicate check and its wait
+	{
+		std::scoped_lock<std::mutex> g(m_sleepMutex);
+	}
+
+	if (numNewJobs == 1)
+	{
+		m_sleepCV.notify_one();
+	}
+	else
+	{
+		m_sleepCV.notify_all();
+	}
+}
+
+uint32_t JobSystem::GetCurrentWorkerIndex()
+{
+	if (s_workerOwner == this)
+	{
+		return s_workerIndex;
+	}
+	return m_nextQueueIndex.fetch_add(1) % static_cast<uint32_t>(m_queues.size());
+}
+
+JobTraceBuffer* JobSystem::GetCurrentTraceBuffer() const
+{
+	if (m_traceBuffers.empty())
+	{
+		return nullptr;
+	}
+	if (s_traceOwner == this)
+	{
+		return s_traceBuffer;
+	}
+
+	// Other threads helping out in WaitFor have no buffer of their own and go untraced
+	return IsMainThread() ? m_traceBuffers[0].get() : nullptr;
+}
+
+void JobSystem::StampEnqueueTime(Job* const* jobs, size_t count) const
+{
+	if (m_traceBuffers.empty())
+	{
+		return;
+	}
+
+	double now = GetCurrentTimeSeconds();
+	for (size_t i = 0; i < count; ++i)
+	{
+		jobs[i]->m_enqueueSeconds = now;
 	}
 }
 
@@ -109,56 +834,210 @@ void JobSystem::Shutdown()
 {
 	if (!m_running.load()) return;
 
+	if (this == g_theJobSystem && g_theEventSystem)
 	{
-		std::scoped_lock<std::mutex> g(m_mutex);
-		m_running.store(false);
+		g_theEventSystem->UnsubscribeEventCallbackFunction("JobBenchmark", JobSystem::Command_JobBenchmark);
+		g_theEventSystem->UnsubscribeEventCallbackFunction("JobTrace", JobSystem::Command_JobTrace);
+	}
+
+	// Finish outstanding reads first; their follow-up jobs still need the CPU workers
+	{
+		std::scoped_lock<std::mutex> g(m_fileIOMutex);
+		m_fileIORunning = false;
 	}
-	m_cv.notify_all();
+	m_fileIOCV.notify_all();
 
-	for (auto& t : m_workers) 
+	for (auto& t : m_fileIOWorkers)
 	{
 		if (t.joinable()) t.join();
 	}
-	m_workers.clear();
+	m_fileIOWorkers.clear();
 
 	{
-		std::scoped_lock<std::mutex> g(m_mutex);
-		for (Job* j : m_pending)   delete j;
-		for (Job* j : m_executing) delete j; 
-		for (Job* j : m_completed) delete j;
+		std::scoped_lock<std::mutex> g(m_sleepMutex);
+		m_running.store(false);
+	}
+	m_sleepCV.notify_all();
 
-		m_pending.clear();
-		m_executing.clear();
-		m_completed.clear();
+	for (auto& t : m_workers)
+	{
+		if (t.joinable()) t.join();
 	}
+	m_workers.clear();
+
+	CancelAllJobs();
 }
 
 
 void JobSystem::CancelPendingJobs()
 {
-	std::scoped_lock lock(m_mutex);
+	std::vector<Job*> cancelled;
+	for (auto& queue : m_queues)
+	{
+		queue->DrainTo(cancelled);
+	}
+	for (Job* job : cancelled)
+	{
+		m_numQueuedJobsByPriority[static_cast<int>(job->m_priority)].fetch_sub(1);
+	}
+	m_numQueuedJobs.fetch_sub(static_cast<int64_t>(cancelled.size()));
 
-	for (Job* job : m_pending) {
-		delete job;
+	{
+		std::scoped_lock<std::mutex> g(m_fileIOMutex);
+		for (std::deque<Job*>& lane : m_fileIOQueues)
+		{
+			cancelled.insert(cancelled.end(), lane.begin(), lane.end());
+			lane.clear();
+		}
 	}
-	m_pending.clear();
 
-	m_cv.notify_all();
+	// Signal the cancelled jobs' counters so nobody waits forever; dependents released that way are cancelled too
+	for (size_t i = 0; i < cancelled.size(); ++i)
+	{
+		JobCounter* counter = cancelled[i]->m_signalOnComplete;
+		DisposeJob(cancelled[i]);
+		if (counter)
+		{
+			SignalCounter(counter, cancelled);
+		}
+	}
 }
 
 void JobSystem::CancelAllJobs()
 {
-	std::scoped_lock lock(m_mutex);
+	CancelPendingJobs();
 
-	for (Job* job : m_pending) {
-		delete job;
+	{
+		std::scoped_lock lock(m_retrieveMutex);
+		while (Job* job = m_completed.Pop()) {
+			delete job;
+		}
 	}
-	m_pending.clear();
 
-	for (Job* job : m_completed) {
+	// Main-thread jobs are consumed by the main thread only, which is also the one shutting down
+	std::vector<Job*> mainThreadJobs;
+	m_mainThreadJobs.PopMany(mainThreadJobs);
+	for (size_t i = 0; i < mainThreadJobs.size(); ++i)
+	{
+		JobCounter* counter = mainThreadJobs[i]->m_signalOnComplete;
+		DisposeJob(mainThreadJobs[i]);
+		if (counter)
+		{
+			SignalCounter(counter, mainThreadJobs);
+		}
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+struct BenchmarkJob : public Job
+{
+	void Execute() override {}
+};
+
+double JobSystem::MeasureCompletionThroughput(uint32_t workerCount, uint32_t numJobs)
+{
+	JobSystemConfig config;
+	config.m_workerCount = workerCount;
+	JobSystem jobSystem(config);
+	jobSystem.Startup();
+
+	std::vector<Job*> jobs;
+	jobs.reserve(numJobs);
+	for (uint32_t i = 0; i < numJobs; ++i)
+	{
+		jobs.push_back(new BenchmarkJob());
+	}
+
+	std::vector<Job*> retrieved;
+	retrieved.reserve(numJobs);
+
+	double startTime = GetCurrentTimeSeconds();
+	jobSystem.EnqueueBatch(jobs);
+	while (retrieved.size() < numJobs)
+	{
+		jobSystem.RetrieveCompleted(retrieved);
+	}
+	double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+
+	jobSystem.Shutdown();
+	for (Job* job : retrieved)
+	{
 		delete job;
 	}
-	m_completed.clear();
 
-	m_cv.notify_all();
+	return (elapsedSeconds > 0.0) ? static_cast<double>(numJobs) / elapsedSeconds : 0.0;
+}
+
+bool JobSystem::Command_JobBenchmark(EventArgs& args)
+{
+	int numJobs = args.GetValue("jobs", 200000);
+	int maxWorkers = args.GetValue("maxWorkers", static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+
+	for (int workerCount = 1; workerCount <= maxWorkers; workerCount *= 2)
+	{
+		double jobsPerSecond = MeasureCompletionThroughput(static_cast<uint32_t>(workerCount), static_cast<uint32_t>(numJobs));
+		if (g_theDevConsole)
+		{
+			g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("JobBenchmark: %2d workers, %d jobs -> %.2f M completions/s",
+				workerCount, numJobs, jobsPerSecond / 1000000.0));
+		}
+	}
+	return true;
+}
+
+bool JobSystem::WriteTrace(std::string const& filePath, int numFrames)
+{
+	if (m_traceBuffers.empty())
+	{
+		return false;
+	}
+
+	// Frame start times live in a ring, so only the most recent JOB_TRACE_FRAME_HISTORY frames can be addressed
+	uint64_t numKnownFrames = std::min<uint64_t>(m_frameNumber, m_frameStartTimes.size());
+	uint64_t numTracedFrames = (numFrames > 0) ? std::min<uint64_t>(static_cast<uint64_t>(numFrames), numKnownFrames) : numKnownFrames;
+	uint64_t firstFrameNumber = m_frameNumber - numTracedFrames;
+
+	std::vector<double> frameStartTimes;
+	for (uint64_t frame = firstFrameNumber; frame < m_frameNumber; ++frame)
+	{
+		frameStartTimes.push_back(m_frameStartTimes[frame % m_frameStartTimes.size()]);
+	}
+	double sinceSeconds = (numFrames > 0 && !frameStartTimes.empty()) ? frameStartTimes.front() : 0.0;
+
+	std::vector<JobTraceThread> threads(m_traceBuffers.size());
+	double originSeconds = frameStartTimes.empty() ? GetCurrentTimeSeconds() : frameStartTimes.front();
+	for (size_t i = 0; i < m_traceBuffers.size(); ++i)
+	{
+		threads[i].m_threadName = m_traceBuffers[i]->GetThreadName();
+		m_traceBuffers[i]->CopyEventsEndingAfter(sinceSeconds, threads[i].m_events);
+		for (JobTraceEvent const& traceEvent : threads[i].m_events)
+		{
+			originSeconds = std::min(originSeconds, traceEvent.m_startSeconds);
+		}
+	}
+
+	std::string json = BuildChromeTraceJson(threads, frameStartTimes, firstFrameNumber, originSeconds);
+	std::vector<uint8_t> fileBuffer(json.begin(), json.end());
+	return FileWriteFromBuffer(fileBuffer, filePath) >= 0;
+}
+
+bool JobSystem::Command_JobTrace(EventArgs& args)
+{
+	int numFrames = args.GetValue("frames", 10);
+	std::string filePath = args.GetValue("file", "JobTrace.json");
+
+	bool wasWritten = g_theJobSystem && g_theJobSystem->WriteTrace(filePath, numFrames);
+	if (g_theDevConsole)
+	{
+		if (wasWritten)
+		{
+			g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("JobTrace: wrote last %d frames to %s (open in ui.perfetto.dev or chrome://tracing)", numFrames, filePath.c_str()));
+		}
+		else
+		{
+			g_theDevConsole->AddLine(DevConsole::ERROR_COLOR, Stringf("JobTrace: could not write %s (is tracing enabled?)", filePath.c_str()));
+		}
+	}
+	return true;
 }
@@ -2,27 +2,230 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <deque>
 #include <queue>
 #include <vector>
+#include <memory>
 #include <functional>
 #include <atomic>
+#include <initializer_list>
 #include <cstdint>
+#include <cstddef>
+#include <new>
+#include <type_traits>
 #include <iostream>
+#include "Engine/Core/MPSCQueue.hpp"
+#include "Engine/Core/JobTrace.hpp"
+#include <algorithm>
+#include <string>
 
-struct Job 
+class JobCounter;
+class JobPool;
+class JobSystem;
+extern JobSystem* g_theJobSystem; // Defined in JobSystem.cpp; the game assigns it
+class NamedStrings;
+typedef NamedStrings EventArgs;
+
+
+//------------------------------------------------------------------------------------------------
+// Workers always take the most urgent lane that has work; within a lane the usual LIFO/steal rules apply
+enum class JobPriority
+{
+	FRAME_CRITICAL,	// Needed before the current frame can finish
+	NORMAL,
+	BACKGROUND,		// Streaming, pathfinding and other work that may lag a few frames
+
+	NUM_JOB_PRIORITIES
+};
+constexpr int NUM_JOB_PRIORITIES = static_cast<int>(JobPriority::NUM_JOB_PRIORITIES);
+
+
+//------------------------------------------------------------------------------------------------
+// Shared by a group of jobs (e.g. everything streaming one chunk). Cancelling it skips every job of the
+// group that hasn't started yet; jobs already running can poll IsCancelled() and bail out early.
+class JobCancellationToken
+{
+public:
+	void Cancel() { m_isCancelled.store(true, std::memory_order_relaxed); }
+	void Reset() { m_isCancelled.store(false, std::memory_order_relaxed); }
+	bool IsCancelled() const { return m_isCancelled.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<bool> m_isCancelled = false;
+};
+
+
+//------------------------------------------------------------------------------------------------
+// Scheduling settings for jobs the system creates itself (lambda jobs)
+struct JobOptions
+{
+	char const*				m_name = nullptr;
+	JobPriority				m_priority = JobPriority::NORMAL;
+	double					m_deadlineSeconds = 0.0;
+	JobCancellationToken*	m_cancellationToken = nullptr;
+};
+
+
+//------------------------------------------------------------------------------------------------
+struct Job
 {
 	virtual ~Job() = default;
 	virtual void Execute() = 0;
+
+	bool m_retrieveWhenComplete = true; // If false, the system deletes the job instead of handing it to RetrieveCompleted
+	char const* m_name = nullptr; // Label in JobTrace captures; must outlive the job (a string literal is ideal)
+	JobPriority m_priority = JobPriority::NORMAL;
+	double m_deadlineSeconds = 0.0; // GetCurrentTimeSeconds() after which the job is skipped if it hasn't started; 0 = none
+	JobCancellationToken* m_cancellationToken = nullptr; // Must outlive the job
+
+	// Skipped jobs never run; they are disposed like CancelPendingJobs' victims and still signal their counter
+	bool IsCancelled() const { return m_cancellationToken && m_cancellationToken->IsCancelled(); }
+	void SetOptions(JobOptions const& options);
+
+private:
+	friend class JobSystem;
+	friend class JobPool;
+	JobCounter*			m_signalOnComplete = nullptr;
+	std::atomic<int>	m_numUnfinishedDependencies = 0;
+	JobPool*			m_ownerPool = nullptr; // Set for recycled slots; these go back to the pool instead of being deleted
+	Job*				m_nextInQueue = nullptr; // Link for the intrusive main-thread and completed queues
+	double				m_enqueueSeconds = 0.0; // Only stamped while tracing
+};
+
+
+inline void Job::SetOptions(JobOptions const& options)
+{
+	m_name = options.m_name;
+	m_priority = options.m_priority;
+	m_deadlineSeconds = options.m_deadlineSeconds;
+	m_cancellationToken = options.m_cancellationToken;
+}
+
+
+//------------------------------------------------------------------------------------------------
+constexpr size_t JOB_INLINE_STORAGE_BYTES = 64;
+
+// Runs a callable stored in-place, so a lambda job costs no allocation beyond its (pooled) slot
+struct LambdaJob : public Job
+{
+	LambdaJob() { m_retrieveWhenComplete = false; }
+	~LambdaJob() { DestroyCallable(); }
+
+	template <typename Fn>
+	void SetCallable(Fn&& fn)
+	{
+		typedef typename std::decay<Fn>::type Callable;
+		static_assert(sizeof(Callable) <= JOB_INLINE_STORAGE_BYTES, "Lambda captures too much for an inline job slot; capture by reference or pointer instead");
+		static_assert(alignof(Callable) <= alignof(std::max_align_t), "Lambda capture alignment too strict for an inline job slot");
+
+		new (m_storage) Callable(std::forward<Fn>(fn));
+		m_invoke = [](void* storage) { (*static_cast<Callable*>(storage))(); };
+		m_destroy = [](void* storage) { static_cast<Callable*>(storage)->~Callable(); };
+	}
+
+	void DestroyCallable()
+	{
+		if (m_destroy)
+		{
+			m_destroy(m_storage);
+			m_destroy = nullptr;
+			m_invoke = nullptr;
+		}
+	}
+
+	void Execute() override { m_invoke(m_storage); }
+
+	alignas(std::max_align_t) unsigned char m_storage[JOB_INLINE_STORAGE_BYTES];
+	void (*m_invoke)(void* storage) = nullptr;
+	void (*m_destroy)(void* storage) = nullptr;
+	uint32_t m_poolIndex = 0;
+};
+
+
+//------------------------------------------------------------------------------------------------
+// Fixed set of LambdaJob slots allocated once; the free list is a lock-free stack of slot indices
+// tagged with a generation to rule out ABA.
+class JobPool
+{
+public:
+	explicit JobPool(uint32_t capacity);
+
+	LambdaJob* Acquire(); // nullptr when every slot is in use
+	void Release(LambdaJob* job);
+
+private:
+	static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+	uint32_t m_capacity = 0;
+	std::unique_ptr<LambdaJob[]> m_slots;
+	std::unique_ptr<std::atomic<uint32_t>[]> m_nextFreeIndex;
+	std::atomic<uint64_t> m_freeHead; // high 32 bits: tag, low 32 bits: slot index
 };
 
 
-struct JobSystemConfig 
+//------------------------------------------------------------------------------------------------
+// Counts unfinished jobs. Every job enqueued with a counter adds one and removes it when done;
+// jobs enqueued "after" a counter launch the moment it drops to zero. A counter that tracks a
+// single job doubles as that job's handle. It must outlive every job that signals or waits on it.
+class JobCounter
+{
+public:
+	JobCounter() = default;
+	JobCounter(JobCounter const& copy) = delete;
+	JobCounter& operator=(JobCounter const& copy) = delete;
+
+	int  GetValue() const { return m_value.load(); }
+	bool IsDone() const { return m_value.load() == 0; }
+
+private:
+	friend class JobSystem;
+	std::atomic<int>	m_value = 0;
+	std::mutex			m_waitingJobsMutex;
+	std::vector<Job*>	m_waitingJobs;
+};
+
+
+struct JobSystemConfig
 {
 	uint32_t m_workerCount = 0;
 	uint32_t m_fileIOWorkerCount = 0;
 	uint32_t m_maxExecuting = 0;
+	uint32_t m_pooledJobCapacity = 4096; // LambdaJob slots; overflow falls back to the heap
+	bool	 m_enableTracing = true; // Two timer reads and one ring-buffer write per job
+	uint32_t m_traceEventsPerThread = 16384;
+
+	// An idle worker polls for m_idleSpinCount rounds, then yields its time slice m_idleYieldCount times, then sleeps.
+	// Spinning workers pick up a burst without the OS wake-up cost; set both to 0 to sleep immediately.
+	uint32_t m_idleSpinCount = 1000;
+	uint32_t m_idleYieldCount = 32;
+
+	bool	 m_pinWorkersToCores = false; // Worker i runs only on core (i + first worker core) modulo the core count
+	bool	 m_reserveMainThreadCore = false; // Pins the Startup thread to core 0 and keeps every worker off it
+};
+
+
+//------------------------------------------------------------------------------------------------
+// One set of priority lanes per worker. The owning worker pushes and pops at the back (LIFO, cache-warm),
+// idle workers steal from the front (FIFO, oldest and usually largest work first).
+class JobWorkerQueue
+{
+public:
+	void Push(Job* job);
+	void PushRange(Job* const* jobs, size_t count);
+	Job* Pop(JobPriority priority);
+	Job* Steal(JobPriority priority);
+	void DrainTo(std::vector<Job*>& out);
+
+private:
+	std::mutex			m_mutex;
+	std::deque<Job*>	m_jobs[NUM_JOB_PRIORITIES];
 };
 
+
+// Receives the bytes read by ReadFileAsync; runs as a regular job on a CPU worker
+typedef std::function<void(std::vector<uint8_t>& fileBuffer, bool wasRead)> FileLoadedCallback;
+
+
 class JobSystem {
 public:
 
@@ -32,28 +235,157 @@ public:
 
 	void Shutdown();
 
+	void BeginFrame(); // Main thread only; runs the jobs that were sent to the main thread
+
 	~JobSystem() { Shutdown(); }
 
-	void Enqueue(Job* j);
+	void Enqueue(Job* j, JobCounter* signalOnComplete = nullptr);
+	void EnqueueBatch(Job* const* jobs, size_t count, JobCounter* signalOnComplete = nullptr); // Distributes across workers with a single wake-up
+	void EnqueueBatch(std::vector<Job*> const& jobs, JobCounter* signalOnComplete = nullptr);
+
+	void EnqueueAfter(Job* j, JobCounter& dependency, JobCounter* signalOnComplete = nullptr);
+	void EnqueueAfter(Job* j, std::initializer_list<JobCounter*> dependencies, JobCounter* signalOnComplete = nullptr);
+
+	// Lambda jobs live in pooled inline slots and are recycled, never retrieved
+	template <typename Fn>
+	void EnqueueLambda(Fn&& fn, JobCounter* signalOnComplete = nullptr, JobOptions const& options = JobOptions());
+	template <typename Fn>
+	void EnqueueLambdaAfter(std::initializer_list<JobCounter*> dependencies, Fn&& fn, JobCounter* signalOnComplete = nullptr, JobOptions const& options = JobOptions());
+	template <typename IndexFn>
+	void EnqueueLambdaBatch(uint32_t count, IndexFn const& fn, JobCounter* signalOnComplete = nullptr, JobOptions const& options = JobOptions()); // Runs fn(i) for i in [0, count)
+
+	// Jobs that must run on the thread that called Startup (e.g. renderer uploads); executed in BeginFrame, or in
+	// WaitFor when the caller opts in
+	void EnqueueMainThread(Job* j, JobCounter* signalOnComplete = nullptr);
+	template <typename Fn>
+	void EnqueueMainThreadLambda(Fn&& fn, JobCounter* signalOnComplete = nullptr);
+	void ExecuteMainThreadJobs();
+
+	// Runs queued worker jobs on the calling thread until the counter reaches zero. Main-thread jobs are left for
+	// BeginFrame unless runMainThreadJobs is set, which a main-thread wait needs if the counter depends on one.
+	void WaitFor(JobCounter& counter, bool runMainThreadJobs = false);
+
+	// For work tracked by a counter that isn't a Job (e.g. a coroutine); every increment needs a matching decrement
+	void IncrementCounter(JobCounter& counter);
+	void DecrementCounter(JobCounter& counter);
+
+	// Blocking file work goes to the dedicated I/O threads so it never stalls a CPU worker
+	void EnqueueFileIO(Job* j, JobCounter* signalOnComplete = nullptr);
+	void ReadFileAsync(std::string const& filePath, FileLoadedCallback const& onLoaded, JobCounter* signalOnComplete = nullptr, JobOptions const& options = JobOptions()); // options apply to both the read and the callback
 
 	void RetrieveCompleted(std::vector<Job*>& out, size_t maxCount = 0);
 
-	void CancelPendingJobs();
+	void CancelPendingJobs(); // Every queued job, regardless of owner; prefer a JobCancellationToken to drop one group of work
 	void CancelAllJobs();
 
+	// Times publishing and retrieving numJobs trivial jobs through a temporary system with workerCount workers
+	static double MeasureCompletionThroughput(uint32_t workerCount, uint32_t numJobs);
+	static bool Command_JobBenchmark(EventArgs& args);
+
+	// Writes every job that finished during the last numFrames frames (0 = whatever the buffers still hold) as Chrome trace JSON
+	bool WriteTrace(std::string const& filePath, int numFrames);
+	static bool Command_JobTrace(EventArgs& args);
+
+	uint32_t GetWorkerCount() const { return m_workerCount; }
+	uint32_t GetFileIOWorkerCount() const { return m_fileIOWorkerCount; }
+	bool IsMainThread() const { return std::this_thread::get_id() == m_mainThreadID; }
+	bool IsWorkerThread() const;
+
 private:
-	void WorkerLoop();
-	
+	void WorkerLoop(uint32_t workerIndex);
+	void FileIOWorkerLoop(uint32_t fileIOWorkerIndex);
+	void ApplyCoreAffinity();
+	Job* FindJob(uint32_t workerIndex);
+	Job* StealJob();
+	Job* TakeQueuedJob(JobPriority priority, uint32_t firstQueueIndex, bool popFirstQueue);
+	void ExecuteJob(Job* job);
+	void DisposeJob(Job* job);
+	LambdaJob* AcquireLambdaJob();
+	void Schedule(Job* const* jobs, size_t count);
+	void SignalCounter(JobCounter* counter, std::vector<Job*>& outReadyJobs);
+	void WakeWorkers(size_t numNewJobs);
+	uint32_t GetCurrentWorkerIndex();
+	JobTraceBuffer* GetCurrentTraceBuffer() const;
+	void StampEnqueueTime(Job* const* jobs, size_t count) const;
+
 private:
 	JobSystemConfig m_config;
+	uint32_t m_workerCount = 1;
 	std::vector<std::thread> m_workers;
 
-	std::vector<Job*> m_pending;  
-	std::vector<Job*> m_executing;
-	std::vector<Job*> m_completed;
+	std::vector<std::unique_ptr<JobWorkerQueue>> m_queues;
+	MPSCQueue<Job, &Job::m_nextInQueue> m_completed;
+	MPSCQueue<Job, &Job::m_nextInQueue> m_mainThreadJobs;
+	std::mutex        m_retrieveMutex; // Only serializes consumers; workers publish lock-free
 
-	std::mutex              m_mutex;
-	std::condition_variable m_cv;
+	std::mutex              m_sleepMutex;
+	std::condition_variable m_sleepCV;
 	std::atomic<bool>       m_running;
-	size_t                  m_maxExecuting;
+	std::atomic<int64_t>    m_numQueuedJobs;
+	std::atomic<int64_t>    m_numQueuedJobsByPriority[NUM_JOB_PRIORITIES] = {};
+	std::atomic<uint32_t>   m_numSleepingWorkers;
+	std::atomic<uint32_t>   m_nextQueueIndex;
+	std::unique_ptr<JobPool> m_jobPool;
+	std::thread::id			m_mainThreadID;
+
+	uint32_t				m_fileIOWorkerCount = 1;
+	std::vector<std::thread> m_fileIOWorkers;
+	std::deque<Job*>		m_fileIOQueues[NUM_JOB_PRIORITIES];
+	std::mutex				m_fileIOMutex;
+	std::condition_variable m_fileIOCV;
+	bool					m_fileIORunning = false;
+
+	// [0] main thread, then one per CPU worker, then one per I/O worker
+	std::vector<std::unique_ptr<JobTraceBuffer>> m_traceBuffers;
+	std::vector<double>		m_frameStartTimes; // Ring of the most recent BeginFrame times
+	uint64_t				m_frameNumber = 0;
 };
+
+
+//------------------------------------------------------------------------------------------------
+template <typename Fn>
+void JobSystem::EnqueueLambda(Fn&& fn, JobCounter* signalOnComplete, JobOptions const& options)
+{
+	LambdaJob* job = AcquireLambdaJob();
+	job->SetCallable(std::forward<Fn>(fn));
+	job->SetOptions(options);
+	Enqueue(job, signalOnComplete);
+}
+
+template <typename Fn>
+void JobSystem::EnqueueLambdaAfter(std::initializer_list<JobCounter*> dependencies, Fn&& fn, JobCounter* signalOnComplete, JobOptions const& options)
+{
+	LambdaJob* job = AcquireLambdaJob();
+	job->SetCallable(std::forward<Fn>(fn));
+	job->SetOptions(options);
+	EnqueueAfter(job, dependencies, signalOnComplete);
+}
+
+template <typename Fn>
+void JobSystem::EnqueueMainThreadLambda(Fn&& fn, JobCounter* signalOnComplete)
+{
+	LambdaJob* job = AcquireLambdaJob();
+	job->SetCallable(std::forward<Fn>(fn));
+	EnqueueMainThread(job, signalOnComplete);
+}
+
+template <typename IndexFn>
+void JobSystem::EnqueueLambdaBatch(uint32_t count, IndexFn const& fn, JobCounter* signalOnComplete, JobOptions const& options)
+{
+	constexpr uint32_t BATCH_SIZE = 64;
+	Job* batch[BATCH_SIZE];
+
+	for (uint32_t first = 0; first < count; first += BATCH_SIZE)
+	{
+		uint32_t batchCount = std::min(BATCH_SIZE, count - first);
+		for (uint32_t i = 0; i < batchCount; ++i)
+		{
+			LambdaJob* job = AcquireLambdaJob();
+			uint32_t index = first + i;
+			job->SetCallable([fn, index]() { fn(index); });
+			job->SetOptions(options);
+			batch[i] = job;
+		}
+		EnqueueBatch(batch, batchCount, signalOnComplete);
+	}
+}
@@ -0,0 +1,290 @@
+#pragma once
+#include "Engine/Core/JobSystem.hpp"
+
+// Coroutine tasks need C++20; translation units built as C++17 simply don't see this API
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+//------------------------------------------------------------------------------------------------
+// Task<T> is a lazily started coroutine. Awaiting a Task starts it on the awaiting thread and
+// resumes the awaiter once it finishes; where the body runs in between is decided by the
+// awaitables below (ResumeOnWorker, ResumeOnMainThread, ReadFileAwaitable, WaitForCounterAwaitable).
+// A top-level task is handed to LaunchTask, which runs it on the job system and owns its lifetime.
+//
+//	Task<void> LoadMesh(std::string path)
+//	{
+//		FileReadResult file = co_await ReadFileAwaitable(*g_theJobSystem, path);	// resumes on a worker
+//		MeshData mesh = ParseMesh(file.m_fileBuffer);
+//		co_await ResumeOnMainThread(*g_theJobSystem);
+//		UploadMesh(mesh);
+//	}
+//	LaunchTask(*g_theJobSystem, LoadMesh("Data/Models/Tank.obj"), &loadCounter);
+template <typename T>
+class Task;
+
+namespace JobTaskDetail
+{
+	struct PromiseBase
+	{
+		struct FinalAwaiter
+		{
+			bool await_ready() const noexcept { return false; }
+
+			template <typename Promise>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+			{
+				PromiseBase& promise = handle.promise();
+				if (promise.m_continuation)
+				{
+					return promise.m_continuation;
+				}
+
+				if (promise.m_launchedBy)
+				{
+					// Launched tasks own themselves; read everything needed before the frame goes away
+					JobSystem* jobSystem = promise.m_launchedBy;
+					JobCounter* counter = promise.m_signalOnComplete;
+					handle.destroy();
+					if (counter)
+					{
+						jobSystem->DecrementCounter(*counter);
+					}
+				}
+				return std::noop_coroutine();
+			}
+
+			void await_resume() const noexcept {}
+		};
+
+		std::suspend_always initial_suspend() const noexcept { return {}; }
+		FinalAwaiter final_suspend() const noexcept { return {}; }
+
+		void unhandled_exception()
+		{
+			if (m_launchedBy)
+			{
+				std::terminate(); // Nobody is left to rethrow to
+			}
+			m_exception = std::current_exception();
+		}
+
+		void RethrowIfFailed()
+		{
+			if (m_exception)
+			{
+				std::rethrow_exception(m_exception);
+			}
+		}
+
+		std::coroutine_handle<>	m_continuation;
+		std::exception_ptr		m_exception;
+		JobSystem*				m_launchedBy = nullptr;
+		JobCounter*				m_signalOnComplete = nullptr;
+	};
+
+	template <typename T>
+	struct Promise : public PromiseBase
+	{
+		Task<T> get_return_object() noexcept;
+
+		template <typename U>
+		void return_value(U&& value) { m_value.emplace(std::forward<U>(value)); }
+
+		T TakeResult()
+		{
+			RethrowIfFailed();
+			return std::move(*m_value);
+		}
+
+		std::optional<T> m_value;
+	};
+
+	template <>
+	struct Promise<void> : public PromiseBase
+	{
+		Task<void> get_return_object() noexcept;
+
+		void return_void() {}
+
+		void TakeResult() { RethrowIfFailed(); }
+	};
+}
+
+
+//------------------------------------------------------------------------------------------------
+template <typename T>
+class Task
+{
+public:
+	typedef JobTaskDetail::Promise<T> promise_type;
+	typedef std::coroutine_handle<promise_type> Handle;
+
+	Task() = default;
+	explicit Task(Handle handle) : m_handle(handle) {}
+	Task(Task&& moveFrom) noexcept : m_handle(std::exchange(moveFrom.m_handle, nullptr)) {}
+	Task& operator=(Task&& moveFrom) noexcept
+	{
+		if (this != &moveFrom)
+		{
+			Reset();
+			m_handle = std::exchange(moveFrom.m_handle, nullptr);
+		}
+		return *this;
+	}
+	Task(Task const& copy) = delete;
+	Task& operator=(Task const& copy) = delete;
+	~Task() { Reset(); }
+
+	bool IsValid() const { return static_cast<bool>(m_handle); }
+	bool IsDone() const { return m_handle && m_handle.done(); }
+
+	struct Awaiter
+	{
+		bool await_ready() const noexcept { return false; }
+
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaitingHandle) noexcept
+		{
+			m_handle.promise().m_continuation = awaitingHandle;
+			return m_handle; // Start the task right here; it resumes us when it finishes
+		}
+
+		T await_resume() { return m_handle.promise().TakeResult(); }
+
+		Handle m_handle;
+	};
+
+	Awaiter operator co_await() && noexcept { return Awaiter{ m_handle }; }
+	Awaiter operator co_await() & noexcept { return Awaiter{ m_handle }; }
+
+	// Gives up ownership of the coroutine frame; used by LaunchTask
+	Handle Release() { return std::exchange(m_handle, nullptr); }
+
+private:
+	void Reset()
+	{
+		if (m_handle)
+		{
+			m_handle.destroy();
+			m_handle = nullptr;
+		}
+	}
+
+private:
+	Handle m_handle;
+};
+
+namespace JobTaskDetail
+{
+	template <typename T>
+	Task<T> Promise<T>::get_return_object() noexcept
+	{
+		return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+	}
+
+	inline Task<void> Promise<void>::get_return_object() noexcept
+	{
+		return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+// Starts a task on a worker; the task frees itself when done and then signals the optional counter
+inline void LaunchTask(JobSystem& jobSystem, Task<void>&& task, JobCounter* signalOnComplete = nullptr)
+{
+	Task<void>::Handle handle = task.Release();
+	if (!handle)
+	{
+		return;
+	}
+
+	handle.promise().m_launchedBy = &jobSystem;
+	handle.promise().m_signalOnComplete = signalOnComplete;
+	if (signalOnComplete)
+	{
+		jobSystem.IncrementCounter(*signalOnComplete);
+	}
+
+	jobSystem.EnqueueLambda([handle]() { handle.resume(); });
+}
+
+
+//------------------------------------------------------------------------------------------------
+// co_await ResumeOnWorker(jobSystem): continue on a CPU worker
+struct ResumeOnWorker
+{
+	explicit ResumeOnWorker(JobSystem& jobSystem) : m_jobSystem(jobSystem) {}
+
+	bool await_ready() const noexcept { return m_jobSystem.IsWorkerThread(); }
+	void await_suspend(std::coroutine_handle<> handle) { m_jobSystem.EnqueueLambda([handle]() { handle.resume(); }); }
+	void await_resume() const noexcept {}
+
+	JobSystem& m_jobSystem;
+};
+
+
+//------------------------------------------------------------------------------------------------
+// co_await ResumeOnMainThread(jobSystem): continue inside the main thread's JobSystem::BeginFrame (or an opted-in WaitFor)
+struct ResumeOnMainThread
+{
+	explicit ResumeOnMainThread(JobSystem& jobSystem) : m_jobSystem(jobSystem) {}
+
+	bool await_ready() const noexcept { return m_jobSystem.IsMainThread(); }
+	void await_suspend(std::coroutine_handle<> handle) { m_jobSystem.EnqueueMainThreadLambda([handle]() { handle.resume(); }); }
+	void await_resume() const noexcept {}
+
+	JobSystem& m_jobSystem;
+};
+
+
+//------------------------------------------------------------------------------------------------
+// co_await WaitForCounterAwaitable(jobSystem, counter): continue on a worker once the counter drains
+struct WaitForCounterAwaitable
+{
+	WaitForCounterAwaitable(JobSystem& jobSystem, JobCounter& counter) : m_jobSystem(jobSystem), m_counter(counter) {}
+
+	bool await_ready() const noexcept { return m_counter.IsDone(); }
+	void await_suspend(std::coroutine_handle<> handle) { m_jobSystem.EnqueueLambdaAfter({ &m_counter }, [handle]() { handle.resume(); }); }
+	void await_resume() const noexcept {}
+
+	JobSystem&	m_jobSystem;
+	JobCounter&	m_counter;
+};
+
+
+//------------------------------------------------------------------------------------------------
+// co_await ReadFileAwaitable(jobSystem, path): read on the I/O lane, continue on a CPU worker with the bytes
+struct FileReadResult
+{
+	std::vector<uint8_t>	m_fileBuffer;
+	bool					m_wasRead = false;
+};
+
+struct ReadFileAwaitable
+{
+	ReadFileAwaitable(JobSystem& jobSystem, std::string const& filePath) : m_jobSystem(jobSystem), m_filePath(filePath) {}
+
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<> handle)
+	{
+		m_jobSystem.ReadFileAsync(m_filePath, [this, handle](std::vector<uint8_t>& fileBuffer, bool wasRead)
+			{
+				m_result.m_fileBuffer.swap(fileBuffer);
+				m_result.m_wasRead = wasRead;
+				handle.resume(); // May finish and free this awaiter; touch nothing afterwards
+			});
+	}
+	FileReadResult await_resume() { return std::move(m_result); }
+
+	JobSystem&		m_jobSystem;
+	std::string		m_filePath;
+	FileReadResult	m_result;
+};
+
+#endif // __cpp_impl_coroutine
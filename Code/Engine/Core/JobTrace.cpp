@@ -0,0 +1,105 @@
+#include "Engine/Core/JobTrace.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <algorithm>
+
+
+//------------------------------------------------------------------------------------------------
+JobTraceBuffer::JobTraceBuffer(std::string const& threadName, uint32_t capacity)
+	: m_threadName(threadName)
+	, m_events(capacity > 0 ? capacity : 1)
+{
+}
+
+void JobTraceBuffer::Record(JobTraceEvent const& traceEvent)
+{
+	uint64_t numRecorded = m_numRecorded.load(std::memory_order_relaxed);
+	m_events[numRecorded % m_events.size()] = traceEvent;
+	m_numRecorded.store(numRecorded + 1, std::memory_order_release);
+}
+
+void JobTraceBuffer::CopyEventsEndingAfter(double sinceSeconds, std::vector<JobTraceEvent>& out) const
+{
+	const uint64_t capacity = m_events.size();
+	uint64_t end = m_numRecorded.load(std::memory_order_acquire);
+	uint64_t begin = (end > capacity) ? end - capacity : 0;
+
+	size_t firstCopied = out.size();
+	for (uint64_t i = begin; i < end; ++i)
+	{
+		out.push_back(m_events[i % capacity]);
+	}
+
+	// Anything the writer may have started overwriting while we copied is unreliable; drop it
+	uint64_t endAfterCopy = m_numRecorded.load(std::memory_order_acquire);
+	uint64_t firstValid = (endAfterCopy + 1 > capacity) ? endAfterCopy + 1 - capacity : 0;
+	size_t numStale = static_cast<size_t>((firstValid > begin) ? std::min(firstValid, end) - begin : 0);
+	out.erase(out.begin() + firstCopied, out.begin() + firstCopied + numStale);
+
+	out.erase(std::remove_if(out.begin() + firstCopied, out.end(), [sinceSeconds](JobTraceEvent const& traceEvent)
+		{
+			return traceEvent.m_endSeconds < sinceSeconds;
+		}), out.end());
+}
+
+
+//------------------------------------------------------------------------------------------------
+static std::string EscapeJsonString(char const* text)
+{
+	std::string escaped;
+	for (char const* c = text; *c != '\0'; ++c)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			escaped.push_back('\\');
+		}
+		escaped.push_back(*c);
+	}
+	return escaped;
+}
+
+static double ToTraceMicroseconds(double seconds, double originSeconds)
+{
+	return (seconds - originSeconds) * 1000000.0;
+}
+
+std::string BuildChromeTraceJson(std::vector<JobTraceThread> const& threads, std::vector<double> const& frameStartTimes, uint64_t firstFrameNumber, double originSeconds)
+{
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool isFirstEvent = true;
+	auto appendEvent = [&json, &isFirstEvent](std::string const& eventJson)
+	{
+		if (!isFirstEvent)
+		{
+			json += ",\n";
+		}
+		json += eventJson;
+		isFirstEvent = false;
+	};
+
+	for (size_t threadIndex = 0; threadIndex < threads.size(); ++threadIndex)
+	{
+		JobTraceThread const& thread = threads[threadIndex];
+		int tid = static_cast<int>(threadIndex);
+		appendEvent(Stringf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", tid, EscapeJsonString(thread.m_threadName.c_str()).c_str()));
+		appendEvent(Stringf("{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"sort_index\":%d}}", tid, tid));
+
+		for (JobTraceEvent const& traceEvent : thread.m_events)
+		{
+			std::string name = EscapeJsonString(traceEvent.m_name ? traceEvent.m_name : "Job");
+			appendEvent(Stringf("{\"name\":\"%s\",\"cat\":\"job\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"queuedUs\":%.3f}}",
+				name.c_str(), tid,
+				ToTraceMicroseconds(traceEvent.m_startSeconds, originSeconds),
+				(traceEvent.m_endSeconds - traceEvent.m_startSeconds) * 1000000.0,
+				(traceEvent.m_startSeconds - traceEvent.m_enqueueSeconds) * 1000000.0));
+		}
+	}
+
+	for (size_t i = 0; i < frameStartTimes.size(); ++i)
+	{
+		appendEvent(Stringf("{\"name\":\"Frame %llu\",\"cat\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":%.3f}",
+			static_cast<unsigned long long>(firstFrameNumber + i), ToTraceMicroseconds(frameStartTimes[i], originSeconds)));
+	}
+
+	json += "\n]}\n";
+	return json;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+//------------------------------------------------------------------------------------------------
+struct JobTraceEvent
+{
+	char const*	m_name = nullptr; // Job::m_name; unnamed jobs show up as "Job"
+	double		m_enqueueSeconds = 0.0;
+	double		m_startSeconds = 0.0;
+	double		m_endSeconds = 0.0;
+};
+
+
+//------------------------------------------------------------------------------------------------
+// Fixed-size ring of trace events written by exactly one thread without locks. Any thread may take a
+// snapshot; slots the writer laps while being copied are detected and dropped rather than blocked on.
+class JobTraceBuffer
+{
+public:
+	JobTraceBuffer(std::string const& threadName, uint32_t capacity);
+
+	void Record(JobTraceEvent const& traceEvent); // Owning thread only
+	void CopyEventsEndingAfter(double sinceSeconds, std::vector<JobTraceEvent>& out) const;
+
+	std::string const& GetThreadName() const { return m_threadName; }
+
+private:
+	std::string					m_threadName;
+	std::vector<JobTraceEvent>	m_events;
+	std::atomic<uint64_t>		m_numRecorded = 0;
+};
+
+
+//------------------------------------------------------------------------------------------------
+struct JobTraceThread
+{
+	std::string					m_threadName;
+	std::vector<JobTraceEvent>	m_events;
+};
+
+// Chrome trace event format, loadable in chrome://tracing and ui.perfetto.dev. One track per thread,
+// one slice per job (with its queue wait as an argument), and a global marker at every frame start.
+std::string BuildChromeTraceJson(std::vector<JobTraceThread> const& threads, std::vector<double> const& frameStartTimes, uint64_t firstFrameNumber, double originSeconds);
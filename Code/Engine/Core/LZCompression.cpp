@@ -0,0 +1,180 @@
+#include "Engine/Core/LZCompression.hpp"
+
+
+//------------------------------------------------------------------------------------------------
+constexpr size_t LZ_MIN_MATCH = 4;
+constexpr size_t LZ_MAX_OFFSET = 65535;
+constexpr int LZ_HASH_BITS = 14;
+constexpr uint32_t LZ_EMPTY_SLOT = 0xFFFFFFFF;
+constexpr size_t LZ_MAX_EXTRA_LENGTH = 0x7FFFFFFF; // Rejects absurd lengths before they can overflow
+
+
+//------------------------------------------------------------------------------------------------
+static uint32_t ReadLZWord(byte_t const* bytes)
+{
+	uint32_t word;
+	memcpy(&word, bytes, sizeof(word));
+	return word;
+}
+
+static uint32_t HashLZWord(uint32_t word)
+{
+	return (word * 2654435761u) >> (32 - LZ_HASH_BITS); // Fibonacci hashing
+}
+
+static void AppendLZLength(std::vector<byte_t>& out, size_t extraLength)
+{
+	while (extraLength >= 255)
+	{
+		out.push_back(255);
+		extraLength -= 255;
+	}
+	out.push_back(static_cast<byte_t>(extraLength));
+}
+
+static void AppendLZSequence(std::vector<byte_t>& out, byte_t const* literals, size_t numLiterals, size_t matchOffset, size_t matchLength)
+{
+	size_t matchCode = (matchLength > 0) ? matchLength - LZ_MIN_MATCH : 0;
+	byte_t token = static_cast<byte_t>(((numLiterals < 15 ? numLiterals : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+	out.push_back(token);
+	if (numLiterals >= 15)
+	{
+		AppendLZLength(out, numLiterals - 15);
+	}
+	out.insert(out.end(), literals, literals + numLiterals);
+
+	if (matchLength > 0)
+	{
+		out.push_back(static_cast<byte_t>(matchOffset & 0xFF));
+		out.push_back(static_cast<byte_t>(matchOffset >> 8));
+		if (matchCode >= 15)
+		{
+			AppendLZLength(out, matchCode - 15);
+		}
+	}
+}
+
+static bool ReadLZLength(std::span<byte_t const> compressed, size_t& inOutOffset, size_t& inOutLength)
+{
+	byte_t lengthByte = 255;
+	while (lengthByte == 255)
+	{
+		if (inOutOffset >= compressed.size() || inOutLength > LZ_MAX_EXTRA_LENGTH)
+		{
+			return false;
+		}
+		lengthByte = compressed[inOutOffset++];
+		inOutLength += lengthByte;
+	}
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------------------
+void CompressLZ(std::span<byte_t const> source, std::vector<byte_t>& outCompressed)
+{
+	byte_t const* sourceBytes = source.data();
+	size_t sourceSize = source.size();
+	outCompressed.reserve(outCompressed.size() + sourceSize / 2 + 16);
+
+	std::vector<uint32_t> hashTable(size_t(1) << LZ_HASH_BITS, LZ_EMPTY_SLOT); // Most recent position of each hashed 4-byte word
+	size_t literalStart = 0;
+	size_t position = 0;
+	while (position + LZ_MIN_MATCH <= sourceSize)
+	{
+		uint32_t word = ReadLZWord(sourceBytes + position);
+		uint32_t hash = HashLZWord(word);
+		uint32_t candidate = hashTable[hash];
+		hashTable[hash] = static_cast<uint32_t>(position);
+
+		if (candidate == LZ_EMPTY_SLOT || position - candidate > LZ_MAX_OFFSET || ReadLZWord(sourceBytes + candidate) != word)
+		{
+			++position;
+			continue;
+		}
+
+		size_t matchLength = LZ_MIN_MATCH;
+		while (position + matchLength < sourceSize && sourceBytes[candidate + matchLength] == sourceBytes[position + matchLength])
+		{
+			++matchLength;
+		}
+		AppendLZSequence(outCompressed, sourceBytes + literalStart, position - literalStart, position - candidate, matchLength);
+
+		// Seed the table from the end of the match so the next repeat is found straight away
+		position += matchLength;
+		literalStart = position;
+		if (position >= 2 && position + 2 <= sourceSize)
+		{
+			hashTable[HashLZWord(ReadLZWord(sourceBytes + position - 2))] = static_cast<uint32_t>(position - 2);
+		}
+	}
+
+	AppendLZSequence(outCompressed, sourceBytes + literalStart, sourceSize - literalStart, 0, 0);
+}
+
+
+//------------------------------------------------------------------------------------------------
+bool DecompressLZ(std::span<byte_t const> compressed, std::span<byte_t> outDecompressed)
+{
+	size_t inOffset = 0;
+	size_t outOffset = 0;
+	size_t outSize = outDecompressed.size();
+	while (inOffset < compressed.size())
+	{
+		byte_t token = compressed[inOffset++];
+
+		size_t numLiterals = token >> 4;
+		if (numLiterals == 15 && !ReadLZLength(compressed, inOffset, numLiterals))
+		{
+			return false;
+		}
+		if (numLiterals > compressed.size() - inOffset || numLiterals > outSize - outOffset)
+		{
+			return false;
+		}
+		if (numLiterals > 0)
+		{
+			memcpy(outDecompressed.data() + outOffset, compressed.data() + inOffset, numLiterals);
+		}
+		inOffset += numLiterals;
+		outOffset += numLiterals;
+
+		if (inOffset == compressed.size())
+		{
+			break; // The final, literals-only sequence
+		}
+
+		if (compressed.size() - inOffset < 2)
+		{
+			return false;
+		}
+		size_t matchOffset = compressed[inOffset] | (static_cast<size_t>(compressed[inOffset + 1]) << 8);
+		inOffset += 2;
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !ReadLZLength(compressed, inOffset, matchLength))
+		{
+			return false;
+		}
+		matchLength += LZ_MIN_MATCH;
+		if (matchOffset == 0 || matchOffset > outOffset || matchLength > outSize - outOffset)
+		{
+			return false;
+		}
+
+		byte_t* destination = outDecompressed.data() + outOffset;
+		byte_t const* match = destination - matchOffset;
+		if (matchOffset >= matchLength)
+		{
+			memcpy(destination, match, matchLength);
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; ++i) // Overlapping: a short pattern repeating
+			{
+				destination[i] = match[i];
+			}
+		}
+		outOffset += matchLength;
+	}
+	return outOffset == outSize;
+}
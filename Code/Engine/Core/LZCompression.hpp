@@ -0,0 +1,18 @@
+#pragma once
+#include "Engine/Core/BufferUtils.hpp"
+#include <span>
+
+
+//------------------------------------------------------------------------------------------------
+// Small self-contained LZ77 codec in the LZ4 style: greedy hash-table matching, byte-aligned sequences of
+// (literal run, back reference) and no entropy coding, so both directions run at memory speed. Structured
+// data (grids, meshes, repeated records) typically shrinks to a third or less.
+//
+// Each sequence is a token byte (literal count << 4 | (match length - 4)), with 15 meaning "more length
+// bytes follow, each adding up to 255", then the literals, then a 16-bit little-endian match offset. The
+// last sequence is literals only. The stream doesn't record its decompressed size; store it alongside.
+void CompressLZ(std::span<byte_t const> source, std::vector<byte_t>& outCompressed); // Appends to outCompressed
+
+// outDecompressed must be exactly the original size. Returns false for a corrupt stream or a size mismatch
+// and never reads or writes out of bounds, so untrusted files are safe to feed it.
+bool DecompressLZ(std::span<byte_t const> compressed, std::span<byte_t> outDecompressed);
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+
+//------------------------------------------------------------------------------------------------
+// Intrusive multi-producer / single-consumer queue. Producers push with a single CAS on a shared
+// head (lock-free, no allocation; the link lives in the item itself). The consumer swaps the whole
+// chain out in one exchange and reverses it into a private list, so popping k items costs O(k)
+// and items come out in the order they were pushed.
+//
+// Push may be called from any thread. Pop/PopMany/IsEmpty must only be called by one thread at a time.
+template <typename T, T* T::*NextMember>
+class MPSCQueue
+{
+public:
+	MPSCQueue() = default;
+	MPSCQueue(MPSCQueue const& copy) = delete;
+	MPSCQueue& operator=(MPSCQueue const& copy) = delete;
+
+	void Push(T* item)
+	{
+		T* head = m_pushHead.load(std::memory_order_relaxed);
+		do
+		{
+			item->*NextMember = head;
+		} while (!m_pushHead.compare_exchange_weak(head, item, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	T* Pop()
+	{
+		if (m_popHead == nullptr)
+		{
+			TakePushedItems();
+		}
+
+		T* item = m_popHead;
+		if (item)
+		{
+			m_popHead = item->*NextMember;
+			item->*NextMember = nullptr;
+		}
+		return item;
+	}
+
+	// Appends up to maxCount items (0 = everything available) to out; returns how many were taken
+	size_t PopMany(std::vector<T*>& out, size_t maxCount = 0)
+	{
+		size_t numPopped = 0;
+		while (maxCount == 0 || numPopped < maxCount)
+		{
+			T* item = Pop();
+			if (item == nullptr)
+			{
+				break;
+			}
+			out.push_back(item);
+			++numPopped;
+		}
+		return numPopped;
+	}
+
+	bool IsEmpty() const
+	{
+		return m_popHead == nullptr && m_pushHead.load(std::memory_order_acquire) == nullptr;
+	}
+
+private:
+	void TakePushedItems()
+	{
+		T* chain = m_pushHead.exchange(nullptr, std::memory_order_acquire);
+
+		// The pushed chain is newest-first; reversing it restores push order
+		T* reversed = nullptr;
+		while (chain)
+		{
+			T* next = chain->*NextMember;
+			chain->*NextMember = reversed;
+			reversed = chain;
+			chain = next;
+		}
+		m_popHead = reversed;
+	}
+
+private:
+	std::atomic<T*>	m_pushHead = nullptr;
+	T*				m_popHead = nullptr;
+};
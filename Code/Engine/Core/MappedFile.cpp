@@ -0,0 +1,187 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Engine/Core/MappedFile.hpp"
+
+
+//------------------------------------------------------------------------------------------------
+MappedFile::MappedFile(std::string const& filePath)
+{
+	Open(filePath);
+}
+
+
+//------------------------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+
+//------------------------------------------------------------------------------------------------
+MappedFile::MappedFile(MappedFile&& moveFrom) noexcept
+{
+	TakeMappingFrom(moveFrom);
+}
+
+
+//------------------------------------------------------------------------------------------------
+MappedFile& MappedFile::operator=(MappedFile&& moveFrom) noexcept
+{
+	if (this != &moveFrom)
+	{
+		Close();
+		TakeMappingFrom(moveFrom);
+	}
+	return *this;
+}
+
+
+//------------------------------------------------------------------------------------------------
+void MappedFile::TakeMappingFrom(MappedFile& moveFrom)
+{
+	m_data = moveFrom.m_data;
+	m_size = moveFrom.m_size;
+	m_isOpen = moveFrom.m_isOpen;
+	moveFrom.m_data = nullptr;
+	moveFrom.m_size = 0;
+	moveFrom.m_isOpen = false;
+#ifdef _WIN32
+	m_fileHandle = moveFrom.m_fileHandle;
+	m_mappingHandle = moveFrom.m_mappingHandle;
+	moveFrom.m_fileHandle = nullptr;
+	moveFrom.m_mappingHandle = nullptr;
+#endif
+}
+
+
+//------------------------------------------------------------------------------------------------
+bool MappedFile::Open(std::string const& filePath)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize))
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	m_fileHandle = fileHandle;
+	m_isOpen = true;
+	if (fileSize.QuadPart == 0)
+	{
+		return true; // Windows can't map an empty file; there's nothing to read anyway
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* view = (mappingHandle != nullptr) ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (view == nullptr)
+	{
+		if (mappingHandle != nullptr)
+		{
+			CloseHandle(mappingHandle);
+		}
+		Close();
+		return false;
+	}
+
+	m_mappingHandle = mappingHandle;
+	m_data = static_cast<unsigned char const*>(view);
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStatus;
+	if (fstat(fileDescriptor, &fileStatus) != 0)
+	{
+		close(fileDescriptor);
+		return false;
+	}
+
+	m_isOpen = true;
+	if (fileStatus.st_size > 0)
+	{
+		// The mapping keeps its own reference to the file, so the descriptor can go straight away
+		void* view = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (view == MAP_FAILED)
+		{
+			close(fileDescriptor);
+			m_isOpen = false;
+			return false;
+		}
+		m_data = static_cast<unsigned char const*>(view);
+		m_size = static_cast<size_t>(fileStatus.st_size);
+	}
+	close(fileDescriptor);
+#endif
+
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------------------
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (m_data != nullptr)
+	{
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mappingHandle != nullptr)
+	{
+		CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+	}
+	if (m_fileHandle != nullptr)
+	{
+		CloseHandle(static_cast<HANDLE>(m_fileHandle));
+	}
+	m_mappingHandle = nullptr;
+	m_fileHandle = nullptr;
+#else
+	if (m_data != nullptr)
+	{
+		munmap(const_cast<unsigned char*>(m_data), m_size);
+	}
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+	m_isOpen = false;
+}
+
+
+//------------------------------------------------------------------------------------------------
+std::span<unsigned char const> MappedFile::GetBytes(size_t offset, size_t size) const
+{
+	if (offset > m_size || size > m_size - offset)
+	{
+		return std::span<unsigned char const>();
+	}
+	return std::span<unsigned char const>(m_data + offset, size);
+}
+
+std::string_view MappedFile::GetText(size_t offset, size_t size) const
+{
+	std::span<unsigned char const> bytes = GetBytes(offset, size);
+	return std::string_view(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+}
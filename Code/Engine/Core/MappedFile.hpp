@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+
+//------------------------------------------------------------------------------------------------
+// Read-only memory mapping of a whole file. Pages are faulted in by the OS as they're touched, so
+// walking a large file keeps resident memory flat and nothing is copied into a heap buffer.
+// Move-only; the mapping is released when the MappedFile is destroyed or Close()d.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile(std::string const& filePath);
+	~MappedFile();
+
+	MappedFile(MappedFile const& copy) = delete;
+	void operator=(MappedFile const& copy) = delete;
+	MappedFile(MappedFile&& moveFrom) noexcept;
+	MappedFile& operator=(MappedFile&& moveFrom) noexcept;
+
+	bool Open(std::string const& filePath); // Closes any current mapping first; false if the file can't be opened or mapped
+	void Close();
+
+	bool IsOpen() const { return m_isOpen; }
+	unsigned char const* GetData() const { return m_data; } // nullptr for an empty file
+	size_t GetSize() const { return m_size; }
+	std::string_view GetText() const { return std::string_view(reinterpret_cast<char const*>(m_data), m_size); }
+	std::span<unsigned char const> GetBytes() const { return std::span<unsigned char const>(m_data, m_size); }
+
+	// Views of part of the file, valid while it stays mapped; empty if the range doesn't fit inside the file
+	std::span<unsigned char const> GetBytes(size_t offset, size_t size) const;
+	std::string_view GetText(size_t offset, size_t size) const;
+
+private:
+	void TakeMappingFrom(MappedFile& moveFrom);
+
+private:
+	unsigned char const*	m_data = nullptr;
+	size_t					m_size = 0;
+	bool					m_isOpen = false;
+#ifdef _WIN32
+	void*					m_fileHandle = nullptr;
+	void*					m_mappingHandle = nullptr;
+#endif
+};
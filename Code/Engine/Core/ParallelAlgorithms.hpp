@@ -0,0 +1,221 @@
+#pragma once
+#include "Engine/Core/JobSystem.hpp"
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+
+//------------------------------------------------------------------------------------------------
+// Data-parallel helpers built on JobSystem. Ranges are split into at most a few chunks per worker
+// (never smaller than grainSize); chunk 0 runs on the calling thread, which then helps drain the
+// rest through WaitFor. With no job system, or a range that fits in one grain, everything runs inline.
+namespace ParallelDetail
+{
+	inline int GetNumChunks(int count, int grainSize, JobSystem* jobSystem)
+	{
+		if (count <= 0) return 0;
+		if (jobSystem == nullptr) return 1;
+
+		grainSize = std::max(grainSize, 1);
+		int maxChunks = static_cast<int>(jobSystem->GetWorkerCount() + 1) * 4;
+		int numGrains = (count + grainSize - 1) / grainSize;
+		return std::min(numGrains, maxChunks);
+	}
+
+	// Runs chunkFn(chunkIndex) for every chunk in [0, numChunks) and returns once all have finished
+	template <typename ChunkFn>
+	void RunChunks(int numChunks, ChunkFn const& chunkFn, JobSystem* jobSystem)
+	{
+		if (numChunks <= 1 || jobSystem == nullptr)
+		{
+			for (int chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
+			{
+				chunkFn(chunkIndex);
+			}
+			return;
+		}
+
+		// The caller is blocked on these chunks, so they jump ahead of anything less urgent
+		JobOptions chunkOptions;
+		chunkOptions.m_name = "ParallelChunk";
+		chunkOptions.m_priority = JobPriority::FRAME_CRITICAL;
+
+		JobCounter counter;
+		jobSystem->EnqueueLambdaBatch(static_cast<uint32_t>(numChunks - 1), [&chunkFn](uint32_t jobIndex)
+			{
+				chunkFn(static_cast<int>(jobIndex) + 1);
+			}, &counter, chunkOptions);
+		chunkFn(0);
+		jobSystem->WaitFor(counter);
+	}
+
+	inline int GetChunkBegin(int begin, int count, int numChunks, int chunkIndex)
+	{
+		return begin + static_cast<int>((static_cast<int64_t>(count) * chunkIndex) / numChunks);
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+// Calls rangeFn(chunkBegin, chunkEnd) over disjoint sub-ranges covering [begin, end)
+template <typename RangeFn>
+void ParallelForRanges(int begin, int end, int grainSize, RangeFn const& rangeFn, JobSystem* jobSystem = g_theJobSystem)
+{
+	int count = end - begin;
+	int numChunks = ParallelDetail::GetNumChunks(count, grainSize, jobSystem);
+	auto chunkFn = [&](int chunkIndex)
+	{
+		rangeFn(ParallelDetail::GetChunkBegin(begin, count, numChunks, chunkIndex),
+			ParallelDetail::GetChunkBegin(begin, count, numChunks, chunkIndex + 1));
+	};
+	ParallelDetail::RunChunks(numChunks, chunkFn, jobSystem);
+}
+
+
+//------------------------------------------------------------------------------------------------
+// Calls fn(i) for every i in [begin, end)
+template <typename IndexFn>
+void ParallelFor(int begin, int end, int grainSize, IndexFn const& fn, JobSystem* jobSystem = g_theJobSystem)
+{
+	ParallelForRanges(begin, end, grainSize, [&fn](int chunkBegin, int chunkEnd)
+		{
+			for (int i = chunkBegin; i < chunkEnd; ++i)
+			{
+				fn(i);
+			}
+		}, jobSystem);
+}
+
+
+//------------------------------------------------------------------------------------------------
+// Folds mapFn(i) over [begin, end) with reduceFn. Partial results are combined in index order, so a
+// non-commutative (but associative) reduceFn gives the same answer as the serial loop.
+template <typename T, typename MapFn, typename ReduceFn>
+T ParallelReduce(int begin, int end, int grainSize, T const& identity, MapFn const& mapFn, ReduceFn const& reduceFn, JobSystem* jobSystem = g_theJobSystem)
+{
+	int count = end - begin;
+	int numChunks = ParallelDetail::GetNumChunks(count, grainSize, jobSystem);
+	std::vector<T> partials(numChunks, identity);
+
+	auto chunkFn = [&](int chunkIndex)
+	{
+		int chunkBegin = ParallelDetail::GetChunkBegin(begin, count, numChunks, chunkIndex);
+		int chunkEnd = ParallelDetail::GetChunkBegin(begin, count, numChunks, chunkIndex + 1);
+		T partial = identity;
+		for (int i = chunkBegin; i < chunkEnd; ++i)
+		{
+			partial = reduceFn(partial, mapFn(i));
+		}
+		partials[chunkIndex] = partial;
+	};
+	ParallelDetail::RunChunks(numChunks, chunkFn, jobSystem);
+
+	T result = identity;
+	for (T const& partial : partials)
+	{
+		result = reduceFn(result, partial);
+	}
+	return result;
+}
+
+
+//------------------------------------------------------------------------------------------------
+// output[i] = input[0] op input[1] op ... op input[i]; input and output may alias
+template <typename T, typename ScanOp = std::plus<T>>
+void ParallelInclusiveScan(T const* input, T* output, int count, int grainSize, ScanOp const& scanOp = ScanOp(), JobSystem* jobSystem = g_theJobSystem)
+{
+	int numChunks = ParallelDetail::GetNumChunks(count, grainSize, jobSystem);
+	if (numChunks == 0) return;
+
+	// Pass 1: scan each chunk independently
+	auto scanChunk = [&](int chunkIndex)
+	{
+		int chunkBegin = ParallelDetail::GetChunkBegin(0, count, numChunks, chunkIndex);
+		int chunkEnd = ParallelDetail::GetChunkBegin(0, count, numChunks, chunkIndex + 1);
+		T running = input[chunkBegin];
+		output[chunkBegin] = running;
+		for (int i = chunkBegin + 1; i < chunkEnd; ++i)
+		{
+			running = scanOp(running, input[i]);
+			output[i] = running;
+		}
+	};
+	ParallelDetail::RunChunks(numChunks, scanChunk, jobSystem);
+	if (numChunks == 1) return;
+
+	// Pass 2: serially accumulate each chunk's carry-in from the previous chunks' totals
+	std::vector<T> carries(numChunks);
+	for (int chunkIndex = 1; chunkIndex < numChunks; ++chunkIndex)
+	{
+		int prevChunkLast = ParallelDetail::GetChunkBegin(0, count, numChunks, chunkIndex) - 1;
+		carries[chunkIndex] = (chunkIndex == 1) ? output[prevChunkLast] : scanOp(carries[chunkIndex - 1], output[prevChunkLast]);
+	}
+
+	// Pass 3: apply the carry to every chunk after the first
+	auto applyCarry = [&](int chunkIndex)
+	{
+		int chunkBegin = ParallelDetail::GetChunkBegin(0, count, numChunks, chunkIndex + 1);
+		int chunkEnd = ParallelDetail::GetChunkBegin(0, count, numChunks, chunkIndex + 2);
+		for (int i = chunkBegin; i < chunkEnd; ++i)
+		{
+			output[i] = scanOp(carries[chunkIndex + 1], output[i]);
+		}
+	};
+	ParallelDetail::RunChunks(numChunks - 1, applyCarry, jobSystem);
+}
+
+template <typename T, typename ScanOp = std::plus<T>>
+void ParallelInclusiveScan(std::vector<T>& values, int grainSize, ScanOp const& scanOp = ScanOp(), JobSystem* jobSystem = g_theJobSystem)
+{
+	ParallelInclusiveScan(values.data(), values.data(), static_cast<int>(values.size()), grainSize, scanOp, jobSystem);
+}
+
+
+//------------------------------------------------------------------------------------------------
+// Stable merge sort: chunks are sorted in parallel, then merged pairwise in parallel passes
+template <typename T, typename Less = std::less<T>>
+void ParallelSort(std::vector<T>& values, int grainSize, Less const& less = Less(), JobSystem* jobSystem = g_theJobSystem)
+{
+	int count = static_cast<int>(values.size());
+	int numChunks = ParallelDetail::GetNumChunks(count, grainSize, jobSystem);
+	if (numChunks <= 1)
+	{
+		std::stable_sort(values.begin(), values.end(), less);
+		return;
+	}
+
+	std::vector<int> bounds(numChunks + 1);
+	for (int chunkIndex = 0; chunkIndex <= numChunks; ++chunkIndex)
+	{
+		bounds[chunkIndex] = ParallelDetail::GetChunkBegin(0, count, numChunks, chunkIndex);
+	}
+
+	auto sortChunk = [&](int chunkIndex)
+	{
+		std::stable_sort(values.begin() + bounds[chunkIndex], values.begin() + bounds[chunkIndex + 1], less);
+	};
+	ParallelDetail::RunChunks(numChunks, sortChunk, jobSystem);
+
+	std::vector<T> scratch(values.size());
+	std::vector<T>* src = &values;
+	std::vector<T>* dst = &scratch;
+	for (int width = 1; width < numChunks; width *= 2)
+	{
+		int numMerges = (numChunks + (2 * width) - 1) / (2 * width);
+		auto mergeRuns = [&](int mergeIndex)
+		{
+			int first = mergeIndex * 2 * width;
+			int beginIndex = bounds[first];
+			int midIndex = bounds[std::min(first + width, numChunks)];
+			int endIndex = bounds[std::min(first + (2 * width), numChunks)];
+			std::merge(src->begin() + beginIndex, src->begin() + midIndex, src->begin() + midIndex, src->begin() + endIndex, dst->begin() + beginIndex, less);
+		};
+		ParallelDetail::RunChunks(numMerges, mergeRuns, jobSystem);
+		std::swap(src, dst);
+	}
+
+	if (src != &values)
+	{
+		values.swap(scratch);
+	}
+}
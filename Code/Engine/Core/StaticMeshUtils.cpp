@@ -3,8 +3,49 @@
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Vec4.hpp"
+#include "Engine/Core/ParallelAlgorithms.hpp"
 
 #include <cstdio>
+#include <unordered_map>
+
+//------------------------------------------------------------------------------------------------
+// A face corner "v", "v/vt", "v//vn" or "v/vt/vn"; missing indices are 0
+struct ObjVertexKey
+{
+	int m_vIdx = 0;
+	int m_vtIdx = 0;
+	int m_vnIdx = 0;
+
+	bool operator==(ObjVertexKey const& compare) const { return m_vIdx == compare.m_vIdx && m_vtIdx == compare.m_vtIdx && m_vnIdx == compare.m_vnIdx; }
+};
+
+struct ObjVertexKeyHash
+{
+	size_t operator()(ObjVertexKey const& key) const
+	{
+		return (static_cast<size_t>(key.m_vIdx) * 73856093u) ^ (static_cast<size_t>(key.m_vtIdx) * 19349663u) ^ (static_cast<size_t>(key.m_vnIdx) * 83492791u);
+	}
+};
+
+constexpr int MAX_OBJ_LINE_TOKENS = 4; // Enough for "v x y z"; faces walk the whole line instead
+
+static ObjVertexKey ParseObjFaceVertex(StringView faceVertex)
+{
+	ObjVertexKey key;
+	size_t firstSlash = faceVertex.find('/');
+	TryParseInt(faceVertex.substr(0, firstSlash), key.m_vIdx);
+	if (firstSlash != StringView::npos)
+	{
+		size_t secondSlash = faceVertex.find('/', firstSlash + 1);
+		TryParseInt(faceVertex.substr(firstSlash + 1, secondSlash - (firstSlash + 1)), key.m_vtIdx);
+		if (secondSlash != StringView::npos)
+		{
+			TryParseInt(faceVertex.substr(secondSlash + 1), key.m_vnIdx);
+		}
+	}
+	return key;
+}
+
 
 bool LoadStaticMeshFile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices, std::string const& filePathNoExtension, Mat44 const& transform)
 {
@@ -27,82 +68,99 @@ bool LoadOBJMeshFile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int
 	std::vector<Vec2> uvs;
 	std::vector<Vec3> normals;
 
-	std::map<std::string, unsigned int> vertexCache;
+	std::unordered_map<ObjVertexKey, unsigned int, ObjVertexKeyHash> vertexCache;
+
+	auto getOrAddVertex = [&](ObjVertexKey const& key) -> unsigned int
+	{
+		auto it = vertexCache.find(key);
+		if (it != vertexCache.end())
+		{
+			return it->second;
+		}
+
+		Vertex_PCUTBN vert;
+		if (key.m_vIdx > 0 && key.m_vIdx <= (int)positions.size())
+			vert.m_position = positions[key.m_vIdx - 1];
+		else
+			vert.m_position = Vec3{ 0,0,0 };
+
+		if (key.m_vtIdx > 0 && key.m_vtIdx <= (int)uvs.size())
+			vert.m_uvTexCoords = uvs[key.m_vtIdx - 1];
+		else
+			vert.m_uvTexCoords = Vec2{ 0,0 };
+
+		if (key.m_vnIdx > 0 && key.m_vnIdx <= (int)normals.size())
+			vert.m_normal = normals[key.m_vnIdx - 1];
+		else
+			vert.m_normal = Vec3{ 0,0,0 };
+
+		vert.m_color = Rgba8::WHITE;
+
+		verts.push_back(vert);
+		unsigned int newIndex = static_cast<unsigned int>(verts.size() - 1);
+		vertexCache[key] = newIndex;
+		return newIndex;
+	};
 
 	char lineBuffer[1024];
 	while (fgets(lineBuffer, sizeof(lineBuffer), file))
 	{
-		std::string line(lineBuffer);
-		if (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
-			line.pop_back();
-
+		StringView line = TrimStringView(lineBuffer);
 		if (line.empty() || line[0] == '#')
 			continue;
 
-		std::vector<std::string> tokens = SplitStringOnDelimiter(line, ' ');
-		if (tokens.empty())
+		StringView tokens[MAX_OBJ_LINE_TOKENS];
+		int numTokens = SplitStringViewOnDelimiter(line, ' ', tokens, MAX_OBJ_LINE_TOKENS); // The full count; only v/vt/vn read the array
+		if (numTokens == 0)
 			continue;
 
-		if (tokens[0] == "v" && tokens.size() >= 4)
+		if (tokens[0] == "v" && numTokens >= 4)
 		{
-			Vec3 pos{ std::stof(tokens[1]), std::stof(tokens[2]), std::stof(tokens[3]) };
+			Vec3 pos;
+			TryParseFloat(tokens[1], pos.x);
+			TryParseFloat(tokens[2], pos.y);
+			TryParseFloat(tokens[3], pos.z);
 			positions.push_back(pos);
 		}
-		else if (tokens[0] == "vt" && tokens.size() >= 3)
+		else if (tokens[0] == "vt" && numTokens >= 3)
 		{
-			Vec2 uv{ std::stof(tokens[1]), std::stof(tokens[2]) };
+			Vec2 uv;
+			TryParseFloat(tokens[1], uv.x);
+			TryParseFloat(tokens[2], uv.y);
 			
 			uvs.push_back(uv);
 		}
-		else if (tokens[0] == "vn" && tokens.size() >= 4)
+		else if (tokens[0] == "vn" && numTokens >= 4)
 		{
-			Vec3 norm{ std::stof(tokens[1]), std::stof(tokens[2]), std::stof(tokens[3]) };
+			Vec3 norm;
+			TryParseFloat(tokens[1], norm.x);
+			TryParseFloat(tokens[2], norm.y);
+			TryParseFloat(tokens[3], norm.z);
 			normals.push_back(norm);
 		}
-		else if (tokens[0] == "f" && tokens.size() >= 4)
+		else if (tokens[0] == "f" && numTokens >= 4)
 		{
-			for (size_t tri = 2; tri < tokens.size() - 1; ++tri)
+			// Fan-triangulate a polygon of any size: (first, previous, current) for each corner after the second
+			unsigned int firstIndex = 0;
+			unsigned int previousIndex = 0;
+			int cornerNumber = -1; // The "f" itself
+			for (StringView corner : StringViewSplitter(line, ' '))
 			{
-				std::string vertStr[3] = { tokens[1], tokens[tri], tokens[tri + 1] };
-				for (int vi = 0; vi < 3; ++vi)
+				if (cornerNumber++ < 0)
+					continue;
+
+				unsigned int cornerIndex = getOrAddVertex(ParseObjFaceVertex(corner));
+				if (cornerNumber == 1)
+				{
+					firstIndex = cornerIndex;
+				}
+				else if (cornerNumber >= 3)
 				{
-					std::string key = vertStr[vi];
-					auto it = vertexCache.find(key);
-					if (it != vertexCache.end())
-					{
-						indices.push_back(it->second);
-					}
-					else
-					{
-						std::vector<std::string> parts = SplitStringOnDelimiter(key, '/');
-						int vIdx = (parts.size() > 0) ? std::stoi(parts[0]) : 0;
-						int vtIdx = (parts.size() > 1 && !parts[1].empty()) ? std::stoi(parts[1]) : 0;
-						int vnIdx = (parts.size() > 2) ? std::stoi(parts[2]) : 0;
-
-						Vertex_PCUTBN vert;
-						if (vIdx > 0 && vIdx <= (int)positions.size())
-							vert.m_position = positions[vIdx - 1];
-						else
-							vert.m_position = Vec3{ 0,0,0 };
-
-						if (vtIdx > 0 && vtIdx <= (int)uvs.size())
-							vert.m_uvTexCoords = uvs[vtIdx - 1];
-						else
-							vert.m_uvTexCoords = Vec2{ 0,0 };
-
-						if (vnIdx > 0 && vnIdx <= (int)normals.size())
-							vert.m_normal = normals[vnIdx - 1];
-						else
-							vert.m_normal = Vec3{ 0,0,0 };
-
-						vert.m_color = Rgba8::WHITE;
-
-						verts.push_back(vert);
-						unsigned int newIndex = static_cast<unsigned int>(verts.size() - 1);
-						indices.push_back(newIndex);
-						vertexCache[key] = newIndex;
-					}
+					indices.push_back(firstIndex);
+					indices.push_back(previousIndex);
+					indices.push_back(cornerIndex);
 				}
+				previousIndex = cornerIndex;
 			}
 		}
 	}
@@ -112,13 +170,14 @@ bool LoadOBJMeshFile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int
 	ComputeMissingNormals(verts, indices);
 	ComputeMissingTangentsBitangents(verts, indices);
 
-	for (auto& vert : verts)
-	{
-		vert.m_position = transform.TransformPosition3D(vert.m_position);
-		vert.m_normal = transform.TransformVectorQuantity3D(vert.m_normal).GetNormalized();
-		vert.m_tangent = transform.TransformVectorQuantity3D(vert.m_tangent).GetNormalized();
-		vert.m_bitangent = transform.TransformVectorQuantity3D(vert.m_bitangent).GetNormalized();
-	}
+	ParallelFor(0, static_cast<int>(verts.size()), 2048, [&](int vertIndex)
+		{
+			Vertex_PCUTBN& vert = verts[vertIndex];
+			vert.m_position = transform.TransformPosition3D(vert.m_position);
+			vert.m_normal = transform.TransformVectorQuantity3D(vert.m_normal).GetNormalized();
+			vert.m_tangent = transform.TransformVectorQuantity3D(vert.m_tangent).GetNormalized();
+			vert.m_bitangent = transform.TransformVectorQuantity3D(vert.m_bitangent).GetNormalized();
+		});
 
 	return true;
 }
@@ -1,5 +1,6 @@
 #include "Engine/Core/StringUtils.hpp"
 #include <stdarg.h>
+#include <charconv>
 #include <string>
 #include <vector>
 
@@ -93,3 +94,142 @@ std::string CleanupString(const std::string& input)
 }
 
 
+//-----------------------------------------------------------------------------------------------
+StringViewSplitter::Iterator::Iterator(StringView text, char delimiter, size_t tokenStart)
+	: m_text(text)
+	, m_delimiter(delimiter)
+{
+	FindToken(tokenStart);
+}
+
+StringViewSplitter::Iterator& StringViewSplitter::Iterator::operator++()
+{
+	FindToken(m_tokenEnd);
+	return *this;
+}
+
+void StringViewSplitter::Iterator::FindToken(size_t searchStart)
+{
+	m_tokenStart = (searchStart < m_text.size()) ? m_text.find_first_not_of(m_delimiter, searchStart) : StringView::npos;
+	if (m_tokenStart == StringView::npos)
+	{
+		m_tokenEnd = StringView::npos;
+		return;
+	}
+
+	m_tokenEnd = m_text.find(m_delimiter, m_tokenStart);
+	if (m_tokenEnd == StringView::npos)
+	{
+		m_tokenEnd = m_text.size();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int SplitStringViewOnDelimiter(StringView text, char delimiterToSplitOn, StringView* outTokens, int maxTokens)
+{
+	int numTokens = 0;
+	for (StringView token : StringViewSplitter(text, delimiterToSplitOn))
+	{
+		if (numTokens < maxTokens)
+		{
+			outTokens[numTokens] = token;
+		}
+		++numTokens;
+	}
+	return numTokens;
+}
+
+StringView TrimStringView(StringView text)
+{
+	constexpr char const* WHITESPACE = " \t\r\n";
+	size_t first = text.find_first_not_of(WHITESPACE);
+	if (first == StringView::npos)
+	{
+		return StringView();
+	}
+	size_t last = text.find_last_not_of(WHITESPACE);
+	return text.substr(first, last - first + 1);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool TryParseInt(StringView text, int& outValue)
+{
+	text = TrimStringView(text);
+	if (text.size() > 1 && text[0] == '+')
+	{
+		text.remove_prefix(1); // from_chars only takes a leading '-'
+	}
+
+	int value = 0;
+	std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+	if (text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size())
+	{
+		return false;
+	}
+
+	outValue = value;
+	return true;
+}
+
+bool TryParseFloat(StringView text, float& outValue)
+{
+	text = TrimStringView(text);
+	if (text.size() > 1 && text[0] == '+')
+	{
+		text.remove_prefix(1);
+	}
+
+	float value = 0.f;
+	std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+	if (text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size())
+	{
+		return false;
+	}
+
+	outValue = value;
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static char ToLowerAscii(char c)
+{
+	return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool AreStringsEqualCaseInsensitive(StringView a, StringView b)
+{
+	if (a.size() != b.size())
+	{
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (ToLowerAscii(a[i]) != ToLowerAscii(b[i]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int CompareStringsCaseInsensitive(StringView a, StringView b)
+{
+	size_t commonLength = (a.size() < b.size()) ? a.size() : b.size();
+	for (size_t i = 0; i < commonLength; ++i)
+	{
+		unsigned char lowerA = static_cast<unsigned char>(ToLowerAscii(a[i]));
+		unsigned char lowerB = static_cast<unsigned char>(ToLowerAscii(b[i]));
+		if (lowerA != lowerB)
+		{
+			return (lowerA < lowerB) ? -1 : 1;
+		}
+	}
+	if (a.size() == b.size())
+	{
+		return 0;
+	}
+	return (a.size() < b.size()) ? -1 : 1;
+}
@@ -1,6 +1,7 @@
 #pragma once
 //-----------------------------------------------------------------------------------------------
 #include <string>
+#include <string_view>
 #include <vector>
 
 
@@ -16,6 +17,56 @@ std::string ToLower(const std::string& str);
 std::string CleanupString(const std::string& input);
 
 
+//-----------------------------------------------------------------------------------------------
+// Non-allocating string helpers. A StringView points into someone else's characters, so it must
+// not outlive them; none of these copy or lowercase their inputs.
+typedef std::string_view StringView;
+
+// Walks the tokens of text between delimiters; like SplitStringOnDelimiter, empty tokens are skipped.
+//	for (StringView token : StringViewSplitter(line, ' ')) { ... }
+class StringViewSplitter
+{
+public:
+	class Iterator
+	{
+	public:
+		Iterator(StringView text, char delimiter, size_t tokenStart);
+		StringView	operator*() const { return m_text.substr(m_tokenStart, m_tokenEnd - m_tokenStart); }
+		Iterator&	operator++();
+		bool		operator!=(Iterator const& compare) const { return m_tokenStart != compare.m_tokenStart; }
+		bool		operator==(Iterator const& compare) const { return m_tokenStart == compare.m_tokenStart; }
+
+	private:
+		void		FindToken(size_t searchStart);
+
+	private:
+		StringView	m_text;
+		char		m_delimiter = ' ';
+		size_t		m_tokenStart = 0;
+		size_t		m_tokenEnd = 0;
+	};
+
+	StringViewSplitter(StringView text, char delimiter) : m_text(text), m_delimiter(delimiter) {}
+	Iterator begin() const { return Iterator(m_text, m_delimiter, 0); }
+	Iterator end() const { return Iterator(m_text, m_delimiter, StringView::npos); }
+
+private:
+	StringView	m_text;
+	char		m_delimiter = ' ';
+};
+
+// Fills up to maxTokens views and returns the total number of (non-empty) tokens, which may be more
+int SplitStringViewOnDelimiter(StringView text, char delimiterToSplitOn, StringView* outTokens, int maxTokens);
+StringView TrimStringView(StringView text); // Strips leading and trailing spaces, tabs, \r and \n
+
+// The whole (trimmed) view must be a number; returns false and leaves outValue alone otherwise. No exceptions, no locale.
+bool TryParseInt(StringView text, int& outValue);
+bool TryParseFloat(StringView text, float& outValue);
+
+bool AreStringsEqualCaseInsensitive(StringView a, StringView b);
+int CompareStringsCaseInsensitive(StringView a, StringView b); // <0, 0 or >0, ASCII case folded
+
+
 
 
 
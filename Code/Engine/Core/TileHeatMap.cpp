@@ -4,6 +4,9 @@
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Math/FloatRange.hpp"
+#include "Engine/Core/ParallelAlgorithms.hpp"
+
+constexpr int HEAT_MAP_GRAIN_SIZE = 16384;
 
 
 TileHeatMap::TileHeatMap(IntVec2 const& dimensions, float initialValue)
@@ -12,18 +15,12 @@ TileHeatMap::TileHeatMap(IntVec2 const& dimensions, float initialValue)
 	int numTiles = dimensions.x * dimensions.y;
 	m_values = new float[numTiles];
 
-	for (int i = 0; i < numTiles; ++i)
-	{
-		m_values[i] = initialValue;
-	}
+	ParallelFor(0, numTiles, HEAT_MAP_GRAIN_SIZE, [&](int i) { m_values[i] = initialValue; });
 }
 
 void TileHeatMap::SetValueForAllTiles(float maxValue)
 {
-	for (int i = 0; i < GetNumTiles(); ++i)
-	{
-		m_values[i] = maxValue;
-	}
+	ParallelFor(0, GetNumTiles(), HEAT_MAP_GRAIN_SIZE, [&](int i) { m_values[i] = maxValue; });
 }
 
 void TileHeatMap::SetValueAtIndex(int tileIndex, float value)
@@ -107,16 +104,8 @@ void TileHeatMap::AddSolidVertsForDebugDraw(std::vector<Vertex_PCU>& verts, AABB
 
 float TileHeatMap::GetMaxValue(float specialValue) const
 {
-	float maxValue = 0.f;
-
-	for (int i = 0; i < m_dimensions.x * m_dimensions.y; ++i)
-	{
-		if (m_values[i] > maxValue && m_values[i] != specialValue)
-		{
-			maxValue = m_values[i];
-		}
-	}
-
-	return maxValue;
+	return ParallelReduce(0, GetNumTiles(), HEAT_MAP_GRAIN_SIZE, 0.f,
+		[&](int i) { return (m_values[i] != specialValue) ? m_values[i] : 0.f; },
+		[](float a, float b) { return (b > a) ? b : a; });
 }
 
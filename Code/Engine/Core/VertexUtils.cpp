@@ -9,30 +9,33 @@
 #include "Engine/Math/FloatRange.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Math/OBB3.hpp"
+#include "Engine/Core/ParallelAlgorithms.hpp"
+
+constexpr int VERTEX_TRANSFORM_GRAIN_SIZE = 4096;
 
 void TransformVertexArrayXY3D(int numVerts, Vertex_PCU* verts, float scaleXY, float rotationDegreesAboutZ, Vec2 const translationXY)
 {
-	for (int vertIndex = 0; vertIndex < numVerts; ++vertIndex)
-	{
-		Vec3& pos = verts[vertIndex].m_position;
-		TransformPositionXY3D(pos, scaleXY, rotationDegreesAboutZ, translationXY);
-	}
+	ParallelFor(0, numVerts, VERTEX_TRANSFORM_GRAIN_SIZE, [&](int vertIndex)
+		{
+			Vec3& pos = verts[vertIndex].m_position;
+			TransformPositionXY3D(pos, scaleXY, rotationDegreesAboutZ, translationXY);
+		});
 }
 
 void TransformVertexArray3D(std::vector<Vertex_PCU>& verts, const Mat44& transform)
 {
-	for (auto& vertex : verts)
-	{
-		vertex.m_position = transform.TransformPosition3D(vertex.m_position);
-	}
+	ParallelFor(0, static_cast<int>(verts.size()), VERTEX_TRANSFORM_GRAIN_SIZE, [&](int vertIndex)
+		{
+			verts[vertIndex].m_position = transform.TransformPosition3D(verts[vertIndex].m_position);
+		});
 }
 
 void TransformVertexArray3D(std::vector<Vertex_PCUTBN>& verts, const Mat44& transform)
 {
-	for (auto& vertex : verts)
-	{
-		vertex.m_position = transform.TransformPosition3D(vertex.m_position);
-	}
+	ParallelFor(0, static_cast<int>(verts.size()), VERTEX_TRANSFORM_GRAIN_SIZE, [&](int vertIndex)
+		{
+			verts[vertIndex].m_position = transform.TransformPosition3D(verts[vertIndex].m_position);
+		});
 }
 
 AABB2 GetVertexBounds2D(const std::vector<Vertex_PCU>& verts)
@@ -0,0 +1,516 @@
+#include "Engine/Core/XmlStreamReader.hpp"
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/FloatRange.hpp"
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+
+constexpr int MAX_XML_STREAM_VALUE_TOKENS = 4;
+
+
+//------------------------------------------------------------------------------------------------
+static bool IsXmlWhitespace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+
+//------------------------------------------------------------------------------------------------
+XmlStreamReader::XmlStreamReader(std::string_view text)
+	: m_text(text)
+{
+}
+
+
+//------------------------------------------------------------------------------------------------
+bool XmlStreamReader::OpenFile(std::string const& filePath)
+{
+	*this = XmlStreamReader();
+	if (!m_mappedFile.Open(filePath))
+	{
+		Fail("Could not open " + filePath);
+		return false;
+	}
+
+	m_text = m_mappedFile.GetText();
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------------------
+XmlStreamToken XmlStreamReader::ReadNext()
+{
+	if (m_hasFailed)
+	{
+		return XmlStreamToken::PARSE_ERROR;
+	}
+
+	m_attributes.clear();
+	if (m_isPendingEnd)
+	{
+		m_isPendingEnd = false;
+		m_depth = static_cast<int>(m_openElements.size());
+		m_openElements.pop_back();
+		return XmlStreamToken::END_ELEMENT;
+	}
+
+	for (;;)
+	{
+		size_t tagStart = m_text.find('<', m_cursor);
+		if (tagStart == std::string_view::npos)
+		{
+			m_cursor = m_text.size();
+			if (!m_openElements.empty())
+			{
+				return Fail("Unexpected end of document inside <" + std::string(m_openElements.back()) + ">");
+			}
+			m_elementName = std::string_view();
+			m_depth = 0;
+			return XmlStreamToken::END_OF_DOCUMENT;
+		}
+
+		m_cursor = tagStart + 1;
+		std::string_view rest = m_text.substr(m_cursor);
+		if (rest.substr(0, 1) == "?")
+		{
+			if (!SkipPast("?>")) return Fail("Unterminated processing instruction");
+		}
+		else if (rest.substr(0, 3) == "!--")
+		{
+			if (!SkipPast("-->")) return Fail("Unterminated comment");
+		}
+		else if (rest.substr(0, 8) == "![CDATA[")
+		{
+			if (!SkipPast("]]>")) return Fail("Unterminated CDATA section");
+		}
+		else if (rest.substr(0, 1) == "!")
+		{
+			if (!SkipPast(">")) return Fail("Unterminated declaration");
+		}
+		else if (rest.substr(0, 1) == "/")
+		{
+			++m_cursor;
+			m_elementName = ReadName();
+			SkipWhitespace();
+			if (m_cursor >= m_text.size() || m_text[m_cursor] != '>')
+			{
+				return Fail("Malformed end tag");
+			}
+			++m_cursor;
+			if (m_openElements.empty() || m_openElements.back() != m_elementName)
+			{
+				return Fail("Mismatched end tag </" + std::string(m_elementName) + ">");
+			}
+			m_depth = static_cast<int>(m_openElements.size());
+			m_openElements.pop_back();
+			return XmlStreamToken::END_ELEMENT;
+		}
+		else
+		{
+			m_elementName = ReadName();
+			if (m_elementName.empty())
+			{
+				return Fail("Missing element name");
+			}
+
+			for (;;)
+			{
+				SkipWhitespace();
+				if (m_cursor >= m_text.size())
+				{
+					return Fail("Unterminated start tag <" + std::string(m_elementName) + ">");
+				}
+
+				char c = m_text[m_cursor];
+				if (c == '>')
+				{
+					++m_cursor;
+					break;
+				}
+				if (c == '/')
+				{
+					if (m_cursor + 1 >= m_text.size() || m_text[m_cursor + 1] != '>')
+					{
+						return Fail("Malformed empty element <" + std::string(m_elementName) + ">");
+					}
+					m_cursor += 2;
+					m_isPendingEnd = true;
+					break;
+				}
+
+				XmlStreamAttribute attribute;
+				attribute.m_name = ReadName();
+				SkipWhitespace();
+				if (attribute.m_name.empty() || m_cursor >= m_text.size() || m_text[m_cursor] != '=')
+				{
+					return Fail("Malformed attribute in <" + std::string(m_elementName) + ">");
+				}
+				++m_cursor;
+				SkipWhitespace();
+				if (m_cursor >= m_text.size() || (m_text[m_cursor] != '"' && m_text[m_cursor] != '\''))
+				{
+					return Fail("Unquoted attribute value in <" + std::string(m_elementName) + ">");
+				}
+
+				char quote = m_text[m_cursor];
+				size_t valueStart = m_cursor + 1;
+				size_t valueEnd = m_text.find(quote, valueStart);
+				if (valueEnd == std::string_view::npos)
+				{
+					return Fail("Unterminated attribute value in <" + std::string(m_elementName) + ">");
+				}
+				attribute.m_value = m_text.substr(valueStart, valueEnd - valueStart);
+				m_attributes.push_back(attribute);
+				m_cursor = valueEnd + 1;
+			}
+
+			m_openElements.push_back(m_elementName);
+			m_depth = static_cast<int>(m_openElements.size());
+			return XmlStreamToken::START_ELEMENT;
+		}
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+bool XmlStreamReader::SkipElement()
+{
+	int startDepth = m_depth;
+	for (;;)
+	{
+		XmlStreamToken token = ReadNext();
+		if (token == XmlStreamToken::END_ELEMENT && m_depth == startDepth)
+		{
+			return true;
+		}
+		if (token != XmlStreamToken::START_ELEMENT && token != XmlStreamToken::END_ELEMENT)
+		{
+			return false;
+		}
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+bool XmlStreamReader::FindAttribute(char const* attributeName, std::string_view& outValue) const
+{
+	for (XmlStreamAttribute const& attribute : m_attributes)
+	{
+		if (attribute.m_name == attributeName)
+		{
+			outValue = attribute.m_value;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+//------------------------------------------------------------------------------------------------
+int XmlStreamReader::GetLineNumber() const
+{
+	size_t end = std::min(m_cursor, m_text.size());
+	int lineNumber = 1;
+	for (size_t i = 0; i < end; ++i)
+	{
+		if (m_text[i] == '\n')
+		{
+			++lineNumber;
+		}
+	}
+	return lineNumber;
+}
+
+
+//------------------------------------------------------------------------------------------------
+XmlStreamToken XmlStreamReader::Fail(std::string const& message)
+{
+	m_hasFailed = true;
+	m_attributes.clear();
+	m_errorMessage = Stringf("%s (line %d)", message.c_str(), GetLineNumber());
+	return XmlStreamToken::PARSE_ERROR;
+}
+
+
+//------------------------------------------------------------------------------------------------
+bool XmlStreamReader::SkipPast(std::string_view terminator)
+{
+	size_t found = m_text.find(terminator, m_cursor);
+	if (found == std::string_view::npos)
+	{
+		m_cursor = m_text.size();
+		return false;
+	}
+	m_cursor = found + terminator.size();
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------------------
+void XmlStreamReader::SkipWhitespace()
+{
+	while (m_cursor < m_text.size() && IsXmlWhitespace(m_text[m_cursor]))
+	{
+		++m_cursor;
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+std::string_view XmlStreamReader::ReadName()
+{
+	size_t nameStart = m_cursor;
+	while (m_cursor < m_text.size())
+	{
+		char c = m_text[m_cursor];
+		if (IsXmlWhitespace(c) || c == '>' || c == '/' || c == '=')
+		{
+			break;
+		}
+		++m_cursor;
+	}
+	return m_text.substr(nameStart, m_cursor - nameStart);
+}
+
+
+//------------------------------------------------------------------------------------------------
+// Attribute values sit inside the document and always end at their closing quote, which also stops
+// atoi/atof, so the C parsers can run on them in place just like they do on tinyxml2's strings.
+// Missing tokens parse as 0, where the XmlElement versions would index past the end of their split.
+static int SplitXmlStreamValue(std::string_view value, char delimiter, char const** outTokens)
+{
+	StringView tokens[MAX_XML_STREAM_VALUE_TOKENS];
+	int numTokens = SplitStringViewOnDelimiter(value, delimiter, tokens, MAX_XML_STREAM_VALUE_TOKENS);
+	for (int tokenIndex = 0; tokenIndex < MAX_XML_STREAM_VALUE_TOKENS; ++tokenIndex)
+	{
+		outTokens[tokenIndex] = (tokenIndex < numTokens) ? tokens[tokenIndex].data() : "";
+	}
+	return numTokens;
+}
+
+static std::string DecodeXmlStreamValue(std::string_view value)
+{
+	std::string decoded;
+	decoded.reserve(value.size());
+	for (size_t i = 0; i < value.size(); ++i)
+	{
+		char c = value[i];
+		if (c == '\r')
+		{
+			if (i + 1 < value.size() && value[i + 1] == '\n')
+			{
+				continue; // Same newline normalization as tinyxml2
+			}
+			c = '\n';
+		}
+		else if (c == '&')
+		{
+			size_t entityEnd = value.find(';', i);
+			std::string_view entity = (entityEnd != std::string_view::npos) ? value.substr(i + 1, entityEnd - i - 1) : std::string_view();
+			char replacement = 0;
+			if (entity == "amp") replacement = '&';
+			else if (entity == "lt") replacement = '<';
+			else if (entity == "gt") replacement = '>';
+			else if (entity == "quot") replacement = '"';
+			else if (entity == "apos") replacement = '\'';
+			else if (entity.size() > 1 && entity[0] == '#')
+			{
+				std::string digits(entity.substr(1));
+				bool isHex = (digits[0] == 'x' || digits[0] == 'X');
+				unsigned long codePoint = strtoul(digits.c_str() + (isHex ? 1 : 0), nullptr, isHex ? 16 : 10);
+				if (codePoint > 0 && codePoint < 0x80)
+				{
+					replacement = static_cast<char>(codePoint);
+				}
+			}
+
+			if (replacement != 0)
+			{
+				decoded.push_back(replacement);
+				i = entityEnd;
+				continue;
+			}
+		}
+		decoded.push_back(c);
+	}
+	return decoded;
+}
+
+
+//------------------------------------------------------------------------------------------------
+int ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, int defaultValue)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue))
+	{
+		return atoi(attributeValue.data());
+	}
+
+	return defaultValue;
+}
+
+char ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, char defaultValue)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue) && attributeValue.size() == 1)
+	{
+		return attributeValue[0];
+	}
+
+	return defaultValue;
+}
+
+bool ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, bool defaultValue)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue))
+	{
+		return attributeValue == "true";
+	}
+
+	return defaultValue;
+}
+
+float ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, float defaultValue)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue))
+	{
+		return static_cast<float>(atof(attributeValue.data()));
+	}
+
+	return defaultValue;
+}
+
+Rgba8 ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, Rgba8 const& defaultValue)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue))
+	{
+		char const* tokens[MAX_XML_STREAM_VALUE_TOKENS];
+		int numTokens = SplitXmlStreamValue(attributeValue, ',', tokens);
+		if (numTokens == 3 || numTokens == 4)
+		{
+			unsigned char r = static_cast<unsigned char>(atoi(tokens[0]));
+			unsigned char g = static_cast<unsigned char>(atoi(tokens[1]));
+			unsigned char b = static_cast<unsigned char>(atoi(tokens[2]));
+			unsigned char a = (numTokens == 4) ? static_cast<unsigned char>(atoi(tokens[3])) : 255;
+			return Rgba8(r, g, b, a);
+		}
+		else
+		{
+			printf("Invalid Rgba8 Xml Attribute: %.*s\n", static_cast<int>(attributeValue.size()), attributeValue.data());
+		}
+	}
+
+	return defaultValue;
+}
+
+Vec2 ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, Vec2 const& defaultValue)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue))
+	{
+		char const* tokens[MAX_XML_STREAM_VALUE_TOKENS];
+		if (SplitXmlStreamValue(attributeValue, ',', tokens) != 2)
+		{
+			printf("Invalid Vec2 Xml Attribute");
+		}
+		return Vec2(static_cast<float>(atof(tokens[0])), static_cast<float>(atof(tokens[1])));
+	}
+
+	return defaultValue;
+}
+
+IntVec2 ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, IntVec2 const& defaultValue)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue))
+	{
+		char const* tokens[MAX_XML_STREAM_VALUE_TOKENS];
+		if (SplitXmlStreamValue(attributeValue, ',', tokens) != 2)
+		{
+			printf("Invalid IntVec2 Xml Attribute");
+		}
+		return IntVec2(atoi(tokens[0]), atoi(tokens[1]));
+	}
+
+	return defaultValue;
+}
+
+Vec3 ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, Vec3 const& defaultValue)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue))
+	{
+		char const* tokens[MAX_XML_STREAM_VALUE_TOKENS];
+		SplitXmlStreamValue(attributeValue, ',', tokens);
+		return Vec3(static_cast<float>(atof(tokens[0])), static_cast<float>(atof(tokens[1])), static_cast<float>(atof(tokens[2])));
+	}
+
+	return defaultValue;
+}
+
+EulerAngles ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, EulerAngles const& defaultValue)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue))
+	{
+		char const* tokens[MAX_XML_STREAM_VALUE_TOKENS];
+		SplitXmlStreamValue(attributeValue, ',', tokens);
+		return EulerAngles(static_cast<float>(atof(tokens[0])), static_cast<float>(atof(tokens[1])), static_cast<float>(atof(tokens[2])));
+	}
+
+	return defaultValue;
+}
+
+FloatRange ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, FloatRange const& defaultValue)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue))
+	{
+		char const* tokens[MAX_XML_STREAM_VALUE_TOKENS];
+		SplitXmlStreamValue(attributeValue, '~', tokens);
+		return FloatRange(static_cast<float>(atof(tokens[0])), static_cast<float>(atof(tokens[1])));
+	}
+
+	return defaultValue;
+}
+
+std::string ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, std::string const& defaultValue)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue))
+	{
+		return DecodeXmlStreamValue(attributeValue);
+	}
+
+	return defaultValue;
+}
+
+std::string ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, char const* defaultValue)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue))
+	{
+		return DecodeXmlStreamValue(attributeValue);
+	}
+
+	return std::string(defaultValue);
+}
+
+Strings ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, Strings const& defaultValues)
+{
+	std::string_view attributeValue;
+	if (reader.FindAttribute(attributeName, attributeValue))
+	{
+		return SplitStringOnDelimiter(DecodeXmlStreamValue(attributeValue), ',');
+	}
+
+	return defaultValues;
+}
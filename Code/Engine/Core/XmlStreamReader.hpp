@@ -0,0 +1,98 @@
+#pragma once
+#include "Engine/Core/MappedFile.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+struct Rgba8;
+struct Vec2;
+struct IntVec2;
+struct Vec3;
+struct EulerAngles;
+class FloatRange;
+typedef std::vector<std::string> Strings;
+
+
+//------------------------------------------------------------------------------------------------
+// Pull-style XML reader for large data files. Unlike XmlDocument it never builds a tree: each ReadNext()
+// steps to the next start or end tag, and the element name and attributes are string_views straight into
+// the (memory-mapped) text, so memory stays flat however big the file is. Comments, processing
+// instructions, DOCTYPE, CDATA and text content are skipped. An empty element (<Tile/>) reports
+// START_ELEMENT then END_ELEMENT.
+//
+//	XmlStreamReader reader;
+//	reader.OpenFile("Data/Maps/Huge.xml");
+//	for (XmlStreamToken token = reader.ReadNext(); token == XmlStreamToken::START_ELEMENT || token == XmlStreamToken::END_ELEMENT; token = reader.ReadNext())
+//	{
+//		if (token == XmlStreamToken::START_ELEMENT && reader.GetElementName() == "Tile")
+//		{
+//			IntVec2 coords = ParseXmlAttribute(reader, "coords", IntVec2());
+//		}
+//	}
+enum class XmlStreamToken
+{
+	START_ELEMENT,
+	END_ELEMENT,
+	END_OF_DOCUMENT,
+	PARSE_ERROR
+};
+
+struct XmlStreamAttribute
+{
+	std::string_view	m_name;
+	std::string_view	m_value; // Raw; entities are only decoded by the string forms of ParseXmlAttribute
+};
+
+class XmlStreamReader
+{
+public:
+	XmlStreamReader() = default;
+	explicit XmlStreamReader(std::string_view text); // The caller keeps text alive while reading
+
+	bool			OpenFile(std::string const& filePath); // Maps the whole file; false if it can't be opened
+	XmlStreamToken	ReadNext();
+	bool			SkipElement(); // Call after START_ELEMENT; consumes everything up to and including its END_ELEMENT
+
+	std::string_view	GetElementName() const { return m_elementName; }
+	int					GetDepth() const { return m_depth; } // 1 for the root element, on both its start and end tags
+	std::vector<XmlStreamAttribute> const& GetAttributes() const { return m_attributes; } // Empty for END_ELEMENT
+	bool				FindAttribute(char const* attributeName, std::string_view& outValue) const;
+	std::string const&	GetErrorMessage() const { return m_errorMessage; }
+	int					GetLineNumber() const; // Of the current read position; counted on demand
+
+private:
+	XmlStreamToken	Fail(std::string const& message);
+	bool			SkipPast(std::string_view terminator);
+	void			SkipWhitespace();
+	std::string_view ReadName();
+
+private:
+	MappedFile							m_mappedFile;
+	std::string_view					m_text;
+	size_t								m_cursor = 0;
+	std::string_view					m_elementName;
+	std::vector<XmlStreamAttribute>		m_attributes; // Reused for every element, so it stops allocating after the widest one
+	std::vector<std::string_view>		m_openElements;
+	int									m_depth = 0;
+	bool								m_isPendingEnd = false; // The last START_ELEMENT was self-closing
+	bool								m_hasFailed = false;
+	std::string							m_errorMessage;
+};
+
+
+//------------------------------------------------------------------------------------------------
+// Same parsing rules and defaults as the XmlElement versions in XmlUtils, applied to the current element
+int ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, int defaultValue);
+char ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, char defaultValue);
+bool ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, bool defaultValue);
+float ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, float defaultValue);
+Rgba8 ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, Rgba8 const& defaultValue);
+Vec2 ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, Vec2 const& defaultValue);
+IntVec2 ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, IntVec2 const& defaultValue);
+Vec3 ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, Vec3 const& defaultValue);
+EulerAngles ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, EulerAngles const& defaultValue);
+FloatRange ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, FloatRange const& defaultValue);
+std::string ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, std::string const& defaultValue);
+std::string ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, char const* defaultValue);
+Strings ParseXmlAttribute(XmlStreamReader const& reader, char const* attributeName, Strings const& defaultValues);
@@ -69,8 +69,8 @@ void InputSystem::Startup()
 	{
 		m_controllers[controllerIndex].m_id = controllerIndex;
 	}
-	g_theEventSystem->SubscribeEventCallbackFunction("KeyPressed", InputSystem::Event_KeyPressed);
-	g_theEventSystem->SubscribeEventCallbackFunction("KeyReleased", InputSystem::Event_KeyReleased);
+	g_theEventSystem->Subscribe(InputSystem::Event_KeyPressed);
+	g_theEventSystem->Subscribe(InputSystem::Event_KeyReleased);
 }
 
 void InputSystem::Shutdown()
@@ -229,29 +229,27 @@ Vec2 InputSystem::GetCursorOnScreenPosition(Vec2 cameraSize) const
 	return screenMousePos;
 }
 
-bool InputSystem::Event_KeyPressed(EventArgs& args)
+bool InputSystem::Event_KeyPressed(KeyPressedEvent const& keyEvent)
 {
 	if (!g_theInput)
 	{
 		return false;
 	}
-	unsigned char keyCode = (unsigned char)args.GetValue("KeyCode", -1);
 	if (g_theDevConsole && g_theDevConsole->IsOpen())
 	{
-		return DevConsole::Event_KeyPressed(args);
+		return DevConsole::Event_KeyPressed(keyEvent);
 	}
-	g_theInput->HandleKeyPressed(keyCode);
+	g_theInput->HandleKeyPressed(keyEvent.m_keyCode);
 	return true;
 }
 
-bool InputSystem::Event_KeyReleased(EventArgs& args)
+bool InputSystem::Event_KeyReleased(KeyReleasedEvent const& keyEvent)
 {
 	if (!g_theInput)
 	{
 		return false;
 	}
-	unsigned char keyCode = (unsigned char)args.GetValue("KeyCode", -1);
-	g_theInput->HandleKeyReleased(keyCode);
+	g_theInput->HandleKeyReleased(keyEvent.m_keyCode);
 	return true;
 }
 
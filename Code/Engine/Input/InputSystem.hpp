@@ -5,6 +5,22 @@
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Math/IntVec2.hpp"
 
+// Typed input events, sent with EventSystem::Fire by the window's message handler
+struct KeyPressedEvent
+{
+	unsigned char m_keyCode = 0;
+};
+
+struct KeyReleasedEvent
+{
+	unsigned char m_keyCode = 0;
+};
+
+struct CharInputEvent
+{
+	char m_char = '\0';
+};
+
 extern unsigned char const KEYCODE_F1;
 extern unsigned char const KEYCODE_F2;
 extern unsigned char const KEYCODE_F3;
@@ -91,8 +107,8 @@ public:
 	Vec2 GetCursorOnScreenPosition(Vec2 cameraSize) const;
 
 
-	static bool Event_KeyPressed(EventArgs& args);
-	static bool Event_KeyReleased(EventArgs& args);
+	static bool Event_KeyPressed(KeyPressedEvent const& keyEvent);
+	static bool Event_KeyReleased(KeyReleasedEvent const& keyEvent);
 
 	
 
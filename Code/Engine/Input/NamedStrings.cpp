@@ -6,6 +6,65 @@
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Math/IntVec2.hpp"
 
+
+//------------------------------------------------------------------------------------------------
+namespace
+{
+	enum CachedTypeBits : uint8_t
+	{
+		CACHED_BOOL		= 1 << 0,
+		CACHED_INT		= 1 << 1,
+		CACHED_FLOAT	= 1 << 2,
+		CACHED_RGBA8	= 1 << 3,
+		CACHED_VEC2		= 1 << 4,
+		CACHED_INTVEC2	= 1 << 5,
+		CACHE_WRITER	= 1 << 7,
+	};
+
+	bool IsCached(NamedStrings::TypedValueCache const& cache, uint8_t typeBit)
+	{
+		return (cache.m_readyFlags.load(std::memory_order_acquire) & typeBit) != 0;
+	}
+
+	// A field is written once, before its bit is published, and never again until SetValue. If another
+	// reader is filling a field right now, skip caching; this caller already has its own parsed value.
+	template <typename StoreFn>
+	void CacheValue(NamedStrings::TypedValueCache& cache, uint8_t typeBit, StoreFn const& storeFn)
+	{
+		uint8_t flags = cache.m_readyFlags.fetch_or(CACHE_WRITER, std::memory_order_acquire);
+		if (flags & CACHE_WRITER)
+		{
+			return;
+		}
+		storeFn();
+		cache.m_readyFlags.store(static_cast<uint8_t>(flags | typeBit), std::memory_order_release);
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+NamedStrings::TypedValueCache::TypedValueCache(TypedValueCache const& copyFrom)
+{
+	*this = copyFrom;
+}
+
+
+//------------------------------------------------------------------------------------------------
+void NamedStrings::TypedValueCache::operator=(TypedValueCache const& copyFrom)
+{
+	// Only copy fields whose bits are published; anything else may be mid-write on another thread
+	uint8_t flags = copyFrom.m_readyFlags.load(std::memory_order_acquire) & ~CACHE_WRITER;
+	if (flags & CACHED_BOOL)	m_bool = copyFrom.m_bool;
+	if (flags & CACHED_INT)		m_int = copyFrom.m_int;
+	if (flags & CACHED_FLOAT)	m_float = copyFrom.m_float;
+	if (flags & CACHED_RGBA8)	std::copy(copyFrom.m_rgba8, copyFrom.m_rgba8 + 4, m_rgba8);
+	if (flags & CACHED_VEC2)	std::copy(copyFrom.m_vec2, copyFrom.m_vec2 + 2, m_vec2);
+	if (flags & CACHED_INTVEC2)	std::copy(copyFrom.m_intVec2, copyFrom.m_intVec2 + 2, m_intVec2);
+	m_readyFlags.store(static_cast<uint8_t>(flags), std::memory_order_release);
+}
+
+
+//------------------------------------------------------------------------------------------------
 void NamedStrings::PopulateFromXmlElementAttributes(XmlElement const& element)
 {
 	const XmlAttribute* attribute = element.FirstAttribute();
@@ -13,133 +72,273 @@ void NamedStrings::PopulateFromXmlElementAttributes(XmlElement const& element)
 	{
 		std::string key = attribute->Name();
 		std::string value = attribute->Value();
-		m_keyValuePairs[key] = value;
+		SetValue(key, value);
 		attribute = attribute->Next();
 	}
 }
 
 void NamedStrings::SetValue(std::string const& keyName, std::string const& newValue)
 {
-	m_keyValuePairs[keyName] = newValue;
+	KeyValuePair const* found = FindPair(keyName);
+	if (found)
+	{
+		KeyValuePair& pair = m_keyValuePairs[found - m_keyValuePairs.data()];
+		if (pair.m_value != newValue)
+		{
+			pair.m_value = newValue;
+			pair.m_cache.m_readyFlags.store(0, std::memory_order_relaxed); // Writers need exclusive access anyway
+		}
+		return;
+	}
+
+	// Keep the table at most half full so probes stay short
+	if ((m_keyValuePairs.size() + 1) * 2 > m_tableIndices.size())
+	{
+		RebuildTable(std::max<size_t>(16, m_tableIndices.size() * 2));
+	}
+
+	KeyValuePair newPair;
+	newPair.m_key = keyName;
+	newPair.m_value = newValue;
+	newPair.m_keyHash = HashKey(keyName);
+
+	size_t mask = m_tableIndices.size() - 1;
+	size_t slot = static_cast<size_t>(newPair.m_keyHash) & mask;
+	while (m_tableIndices[slot] >= 0)
+	{
+		slot = (slot + 1) & mask;
+	}
+	m_tableIndices[slot] = static_cast<int>(m_keyValuePairs.size());
+	m_keyValuePairs.push_back(newPair);
 }
 
 std::string NamedStrings::GetValue(std::string const& keyName, std::string const& defaultValue) const
 {
-	auto found = m_keyValuePairs.find(keyName);
-	if (found == m_keyValuePairs.end())
+	KeyValuePair const* found = FindPair(keyName);
+	if (found == nullptr)
 	{
 		return defaultValue;
 	}
 
-	return found->second;
+	return found->m_value;
 }
 
 bool NamedStrings::GetValue(std::string const& keyName, bool defaultValue) const
 {
-	auto found = m_keyValuePairs.find(keyName);
-
-	if (found == m_keyValuePairs.end())
+	KeyValuePair const* found = FindPair(keyName);
+	if (found == nullptr)
 	{
 		return defaultValue;
 	}
 
-	std::string value = found->second;
-
-	if (value == "true")
-	{
-		return true;
-	}
-	else if (value == "false")
+	TypedValueCache& cache = found->m_cache;
+	if (!IsCached(cache, CACHED_BOOL))
 	{
-		return false;
+		int8_t value = -1;
+		if (found->m_value == "true")
+		{
+			value = 1;
+		}
+		else if (found->m_value == "false")
+		{
+			value = 0;
+		}
+		CacheValue(cache, CACHED_BOOL, [&]() { cache.m_bool = value; });
+		return (value < 0) ? defaultValue : (value == 1);
 	}
 
-	return defaultValue;
+	return (cache.m_bool < 0) ? defaultValue : (cache.m_bool == 1);
 }
 
 int NamedStrings::GetValue(std::string const& keyName, int defaultValue) const
 {
-	auto found = m_keyValuePairs.find(keyName);
-
-	if (found == m_keyValuePairs.end())
+	KeyValuePair const* found = FindPair(keyName);
+	if (found == nullptr)
 	{
 		return defaultValue;
 	}
 
-	return std::stoi(found->second);
+	TypedValueCache& cache = found->m_cache;
+	if (IsCached(cache, CACHED_INT))
+	{
+		return cache.m_int;
+	}
+
+	int value = std::stoi(found->m_value);
+	CacheValue(cache, CACHED_INT, [&]() { cache.m_int = value; });
+	return value;
 }
 
 float NamedStrings::GetValue(std::string const& keyName, float defaultValue) const
 {
-	auto found = m_keyValuePairs.find(keyName);
-
-	if (found == m_keyValuePairs.end())
+	KeyValuePair const* found = FindPair(keyName);
+	if (found == nullptr)
 	{
 		return defaultValue;
 	}
 
-	return std::stof(found->second);
+	TypedValueCache& cache = found->m_cache;
+	if (IsCached(cache, CACHED_FLOAT))
+	{
+		return cache.m_float;
+	}
+
+	float value = std::stof(found->m_value);
+	CacheValue(cache, CACHED_FLOAT, [&]() { cache.m_float = value; });
+	return value;
 }
 
 std::string NamedStrings::GetValue(std::string const& keyName, char const* defaultValue) const
 {
-	auto found = m_keyValuePairs.find(keyName);
-
-	if (found == m_keyValuePairs.end())
+	KeyValuePair const* found = FindPair(keyName);
+	if (found == nullptr)
 	{
 		return std::string(defaultValue);
 	}
 
-	return found->second;
+	return found->m_value;
 }
 
 Rgba8 NamedStrings::GetValue(std::string const& keyName, Rgba8 const& defaultValue) const
 {
-	auto found = m_keyValuePairs.find(keyName);
-
-	if (found == m_keyValuePairs.end())
+	KeyValuePair const* found = FindPair(keyName);
+	if (found == nullptr)
 	{
 		return defaultValue;
 	}
 
-	Rgba8 value;
-	value.SetFromText(found->second.c_str());
+	TypedValueCache& cache = found->m_cache;
+	if (IsCached(cache, CACHED_RGBA8))
+	{
+		return Rgba8(cache.m_rgba8[0], cache.m_rgba8[1], cache.m_rgba8[2], cache.m_rgba8[3]);
+	}
 
+	Rgba8 value;
+	value.SetFromText(found->m_value.c_str());
+	CacheValue(cache, CACHED_RGBA8, [&]()
+		{
+			cache.m_rgba8[0] = value.r;
+			cache.m_rgba8[1] = value.g;
+			cache.m_rgba8[2] = value.b;
+			cache.m_rgba8[3] = value.a;
+		});
 	return value;
 }
 
 Vec2 NamedStrings::GetValue(std::string const& keyName, Vec2 const& defaultValue) const
 {
-	auto found = m_keyValuePairs.find(keyName);
-
-	if (found == m_keyValuePairs.end())
+	KeyValuePair const* found = FindPair(keyName);
+	if (found == nullptr)
 	{
 		return defaultValue;
 	}
 
-	Vec2 value;
-	value.SetFromText(found->second.c_str());
+	TypedValueCache& cache = found->m_cache;
+	if (IsCached(cache, CACHED_VEC2))
+	{
+		return Vec2(cache.m_vec2[0], cache.m_vec2[1]);
+	}
 
+	Vec2 value;
+	value.SetFromText(found->m_value.c_str());
+	CacheValue(cache, CACHED_VEC2, [&]()
+		{
+			cache.m_vec2[0] = value.x;
+			cache.m_vec2[1] = value.y;
+		});
 	return value;
 }
 
 IntVec2 NamedStrings::GetValue(std::string const& keyName, IntVec2 const& defaultValue) const
 {
-	auto found = m_keyValuePairs.find(keyName);
-
-	if (found == m_keyValuePairs.end())
+	KeyValuePair const* found = FindPair(keyName);
+	if (found == nullptr)
 	{
 		return defaultValue;
 	}
 
-	IntVec2 value;
-	value.SetFromText(found->second.c_str());
+	TypedValueCache& cache = found->m_cache;
+	if (IsCached(cache, CACHED_INTVEC2))
+	{
+		return IntVec2(cache.m_intVec2[0], cache.m_intVec2[1]);
+	}
 
+	IntVec2 value;
+	value.SetFromText(found->m_value.c_str());
+	CacheValue(cache, CACHED_INTVEC2, [&]()
+		{
+			cache.m_intVec2[0] = value.x;
+			cache.m_intVec2[1] = value.y;
+		});
 	return value;
 }
 
+bool NamedStrings::HasKey(std::string const& keyName) const
+{
+	return FindPair(keyName) != nullptr;
+}
 
+std::map<std::string, std::string> NamedStrings::GetKeyValueMap() const
+{
+	std::map<std::string, std::string> keyValueMap;
+	for (KeyValuePair const& pair : m_keyValuePairs)
+	{
+		keyValueMap.emplace_hint(keyValueMap.end(), pair.m_key, pair.m_value);
+	}
+	return keyValueMap;
+}
+
+
+//------------------------------------------------------------------------------------------------
+uint64_t NamedStrings::HashKey(std::string const& keyName)
+{
+	// FNV-1a; keys are case-sensitive, as they were in the std::map this replaced
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : keyName)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+
+//------------------------------------------------------------------------------------------------
+NamedStrings::KeyValuePair const* NamedStrings::FindPair(std::string const& keyName) const
+{
+	if (m_tableIndices.empty())
+	{
+		return nullptr;
+	}
+
+	uint64_t hash = HashKey(keyName);
+	size_t mask = m_tableIndices.size() - 1;
+	for (size_t slot = static_cast<size_t>(hash) & mask; m_tableIndices[slot] >= 0; slot = (slot + 1) & mask)
+	{
+		KeyValuePair const& pair = m_keyValuePairs[m_tableIndices[slot]];
+		if (pair.m_keyHash == hash && pair.m_key == keyName)
+		{
+			return &pair;
+		}
+	}
+	return nullptr;
+}
 
 
+//------------------------------------------------------------------------------------------------
+void NamedStrings::RebuildTable(size_t numSlots)
+{
+	m_tableIndices.assign(numSlots, -1);
 
+	size_t mask = numSlots - 1;
+	for (int pairIndex = 0; pairIndex < static_cast<int>(m_keyValuePairs.size()); ++pairIndex)
+	{
+		size_t slot = static_cast<size_t>(m_keyValuePairs[pairIndex].m_keyHash) & mask;
+		while (m_tableIndices[slot] >= 0)
+		{
+			slot = (slot + 1) & mask;
+		}
+		m_tableIndices[slot] = pairIndex;
+	}
+}
 
@@ -1,7 +1,10 @@
 #pragma once
 #include "Engine/Core/XmlUtils.hpp"
 #include <string>
+#include <vector>
 #include <map>
+#include <atomic>
+#include <cstdint>
 #include <cctype>
 #include <algorithm>
 
@@ -13,6 +16,32 @@ typedef tinyxml2::XMLElement XmlElement;
 
 class NamedStrings
 {
+public:
+	// Each typed GetValue parses the string once and keeps the result next to it until SetValue replaces the
+	// value. The cache is filled lock-free, so concurrent const reads stay as safe as they were before.
+	struct TypedValueCache
+	{
+		TypedValueCache() = default;
+		TypedValueCache(TypedValueCache const& copyFrom);
+		void operator=(TypedValueCache const& copyFrom);
+
+		std::atomic<uint8_t>	m_readyFlags = 0; // One bit per cached type, plus a bit held while a reader fills a field
+		int8_t					m_bool = -1; // 0 or 1; -1 when the string is neither "true" nor "false"
+		int						m_int = 0;
+		float					m_float = 0.f;
+		unsigned char			m_rgba8[4] = {};
+		float					m_vec2[2] = {};
+		int						m_intVec2[2] = {};
+	};
+
+	struct KeyValuePair
+	{
+		std::string				m_key;
+		std::string				m_value;
+		uint64_t				m_keyHash = 0;
+		mutable TypedValueCache	m_cache;
+	};
+
 public:
 	void			PopulateFromXmlElementAttributes(XmlElement const& element);
 	void			SetValue(std::string const& keyName, std::string const& newValue);
@@ -25,7 +54,17 @@ public:
 	Vec2			GetValue(std::string const& keyName, Vec2 const& defaultValue) const;
 	IntVec2			GetValue(std::string const& keyName, IntVec2 const& defaultValue) const;
 
-public:
-	std::map<std::string, std::string>	m_keyValuePairs;
+	bool			HasKey(std::string const& keyName) const;
+	std::vector<KeyValuePair> const& GetKeyValuePairs() const { return m_keyValuePairs; } // In insertion order
+	std::map<std::string, std::string> GetKeyValueMap() const; // A copy sorted by key, like the public map this class used to hold
+
+private:
+	static uint64_t	HashKey(std::string const& keyName);
+	KeyValuePair const* FindPair(std::string const& keyName) const;
+	void			RebuildTable(size_t numSlots);
+
+private:
+	std::vector<KeyValuePair>	m_keyValuePairs;
+	std::vector<int>			m_tableIndices; // Open addressing, linear probing, power-of-two size; -1 = empty slot
 };
 
@@ -482,7 +482,7 @@ void NetworkSystem::SendCommand(const std::string& commandName, const EventArgs&
 
 	std::string message = commandName;
 
-	for (const auto& pair : args.m_keyValuePairs)
+	for (const auto& pair : args.GetKeyValueMap()) // Sorted by key, so the wire format is unchanged
 	{
 		message += Stringf(" %s=%s", pair.first.c_str(), pair.second.c_str());
 	}
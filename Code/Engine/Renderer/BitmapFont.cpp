@@ -24,7 +24,7 @@ Texture& BitmapFont::GetTexture()
 	return m_fontGlyphsSpriteSheet.GetTexture();
 }
 
-void BitmapFont::AddVertsForText2D(std::vector<Vertex_PCU>& vertexArray, Vec2 const& textMins, float cellHeight, std::string const& text, Rgba8 const& tint, float cellAspectScale)
+void BitmapFont::AddVertsForText2D(std::vector<Vertex_PCU>& vertexArray, Vec2 const& textMins, float cellHeight, std::string_view text, Rgba8 const& tint, float cellAspectScale)
 {
 	Vec2 cursor = textMins;
 
@@ -44,14 +44,20 @@ void BitmapFont::AddVertsForText2D(std::vector<Vertex_PCU>& vertexArray, Vec2 co
 
 void BitmapFont::AddVertsForTextInBox2D(std::vector<Vertex_PCU>& vertexArray, std::string const& text, AABB2 const& box, float cellHeight, Rgba8 const& tint, float cellAspectScale, Vec2 const& alignment, TextBoxMode mode, int maxGlyphsToDraw, float paddingY)
 {
-	Strings lines = SplitStringOnDelimiter(text, '\n');
-	int lineCount = static_cast<int>(lines.size());
-	std::vector<float> lineWidths(lineCount);
-
+	// Two passes over the same line views: measure, then emit; no per-line strings are built. The first pass
+	// keeps its widths for the second, except past MAX_MEASURED_LINES where lines are simply measured again.
+	constexpr int MAX_MEASURED_LINES = 64;
+	float unitLineWidths[MAX_MEASURED_LINES];
+	StringViewSplitter lines(text, '\n');
+	int lineCount = 0;
 	float maxWidth = 0.f;
-	for (int i = 0; i < lineCount; ++i) {
-		lineWidths[i] = GetTextWidth(1.f, lines[i]);
-		maxWidth = std::max(maxWidth, lineWidths[i]);
+	for (StringView line : lines) {
+		float unitLineWidth = GetTextWidth(1.f, line);
+		if (lineCount < MAX_MEASURED_LINES) {
+			unitLineWidths[lineCount] = unitLineWidth;
+		}
+		maxWidth = std::max(maxWidth, unitLineWidth);
+		++lineCount;
 	}
 
 	Vec2 textSize(cellAspectScale * cellHeight * maxWidth, cellHeight * lineCount);
@@ -71,8 +77,11 @@ void BitmapFont::AddVertsForTextInBox2D(std::vector<Vertex_PCU>& vertexArray, st
 	Vec2 textPos = box.m_mins + offset;
 
 	int totalGlyphs = 0;
-	for (int i = 0; i < lineCount && totalGlyphs < maxGlyphsToDraw; ++i) {
-		std::string& line = lines[i];
+	int i = 0;
+	for (StringViewSplitter::Iterator lineIter = lines.begin(); lineIter != lines.end() && totalGlyphs < maxGlyphsToDraw; ++lineIter, ++i) {
+		StringView line = *lineIter;
+		float unitLineWidth = (i < MAX_MEASURED_LINES) ? unitLineWidths[i] : GetTextWidth(1.f, line);
+		float lineWidth = unitLineWidth * cellHeight * cellAspectScale;
 		int glyphsInLine = static_cast<int>(line.length());
 
 		if (totalGlyphs + glyphsInLine > maxGlyphsToDraw) {
@@ -82,7 +91,6 @@ void BitmapFont::AddVertsForTextInBox2D(std::vector<Vertex_PCU>& vertexArray, st
 
 		totalGlyphs += glyphsInLine;
 
-		float lineWidth = lineWidths[i] * cellHeight * cellAspectScale;
 		float extraX = textSize.x - lineWidth;
 		float alignX = GetClampedZeroToOne(alignment.x);
 		float lineX = textPos.x + extraX * alignX;
@@ -126,7 +134,7 @@ void BitmapFont::AddVertsForText3DAtOriginXForward(std::vector<Vertex_PCU>& vert
 	}
 }
 
-float BitmapFont::GetTextWidth(float cellHeight, std::string const& text, float cellAspectScale)
+float BitmapFont::GetTextWidth(float cellHeight, std::string_view text, float cellAspectScale)
 {
 	float totalWidth = 0.0f;
 	for (char c : text)
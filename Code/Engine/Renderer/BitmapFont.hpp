@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <string_view>
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Renderer/SpriteSheet.hpp"
 #include "Engine/Math/Vec2.hpp"
@@ -28,7 +29,7 @@ public:
 	Texture& GetTexture();
 
 	void AddVertsForText2D(std::vector<Vertex_PCU>& vertexArray, Vec2 const& textMins,
-		float cellHeight, std::string const& text, Rgba8 const& tint = Rgba8::WHITE, float cellAspectScale = 1.f);
+		float cellHeight, std::string_view text, Rgba8 const& tint = Rgba8::WHITE, float cellAspectScale = 1.f);
 	void AddVertsForTextInBox2D(std::vector<Vertex_PCU>& vertexArray, std::string const& text, AABB2 const& box, float cellHeight,
 		Rgba8 const& tint = Rgba8::WHITE, float cellAspectScale = 1.f, Vec2 const& alignment = Vec2(.5f, .5f), TextBoxMode mode = TextBoxMode::SHRINK_TO_FIT, 
 		int maxGlyphsToDraw = 99999999, float paddingY = 0.f);
@@ -39,7 +40,7 @@ public:
 	void AddVertsForText3DAtOriginXForward(std::vector<Vertex_PCU>& verts, 
 		float cellHeight, std::string const& text, Rgba8 const& tint = Rgba8::WHITE, 
 		float cellAspect = 1.f, Vec2 const& alignment = Vec2(0.5f, 0.5f), int maxGlyphsToDraw = 99999999);
-	float GetTextWidth(float cellHeight, std::string const& text, float cellAspectScale = 1.f);
+	float GetTextWidth(float cellHeight, std::string_view text, float cellAspectScale = 1.f);
 
 private:
 	float GetGlyphAspect(int glyphUnicode) const; 
@@ -1,11 +1,40 @@
 #include "Engine/Renderer/StaticMeshDefinition.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DefinitionCache.hpp"
+#include "Engine/Core/BufferSchema.hpp"
 
 
 std::vector<StaticMeshDefinition> StaticMeshDefinition::s_meshDefs;
 
+// Bump whenever the schema below changes
+constexpr uint32_t STATIC_MESH_DEFINITION_CACHE_VERSION = 1;
+
+template <>
+struct BufferSchema<StaticMeshDefinition>
+{
+	static constexpr uint32_t VERSION = 0;
+	static constexpr auto FIELDS = std::make_tuple(
+		MakeBufferSchemaField(&StaticMeshDefinition::m_name),
+		MakeBufferSchemaField(&StaticMeshDefinition::m_path),
+		MakeBufferSchemaField(&StaticMeshDefinition::m_shader),
+		MakeBufferSchemaField(&StaticMeshDefinition::m_diffuseMap),
+		MakeBufferSchemaField(&StaticMeshDefinition::m_normalMap),
+		MakeBufferSchemaField(&StaticMeshDefinition::m_specGlossEmitMap),
+		MakeBufferSchemaField(&StaticMeshDefinition::m_unitsPerMeter),
+		MakeBufferSchemaField(&StaticMeshDefinition::m_xAxis),
+		MakeBufferSchemaField(&StaticMeshDefinition::m_yAxis),
+		MakeBufferSchemaField(&StaticMeshDefinition::m_zAxis));
+};
+
 void StaticMeshDefinition::InitializeStaticMeshDefinitions(const char* path)
 {
+	std::vector<StaticMeshDefinition> cachedDefs;
+	if (LoadDefinitionCache(path, STATIC_MESH_DEFINITION_CACHE_VERSION, [&cachedDefs](BufferParser& parser) { ParseSchemaValue(parser, cachedDefs); }))
+	{
+		s_meshDefs.insert(s_meshDefs.end(), cachedDefs.begin(), cachedDefs.end());
+		return;
+	}
+
  	XmlDocument doc;
 	XmlResult result = doc.LoadFile(path);
 	if (result != tinyxml2::XML_SUCCESS)
@@ -19,6 +48,7 @@ void StaticMeshDefinition::InitializeStaticMeshDefinitions(const char* path)
 		ERROR_AND_DIE(std::string(path) + " is missing a root element");
 	}
 
+	std::vector<StaticMeshDefinition> parsedDefs;
 	for (XmlElement* elem = root->FirstChildElement("StaticModelInfo"); elem != nullptr; elem = elem->NextSiblingElement("StaticModelInfo"))
 	{
 		StaticMeshDefinition def;
@@ -35,9 +65,11 @@ void StaticMeshDefinition::InitializeStaticMeshDefinitions(const char* path)
 		def.m_yAxis = ParseXmlAttribute(*elem, "y", "up");
 		def.m_zAxis = ParseXmlAttribute(*elem, "z", "forward");
 
-		s_meshDefs.push_back(def);
+		parsedDefs.push_back(def);
 	}
 
+	SaveDefinitionCache(path, STATIC_MESH_DEFINITION_CACHE_VERSION, [&parsedDefs](BufferWriter& writer) { AppendSchemaValue(writer, parsedDefs); });
+	s_meshDefs.insert(s_meshDefs.end(), parsedDefs.begin(), parsedDefs.end());
 }
 
 StaticMeshDefinition const& StaticMeshDefinition::GetDefinition(std::string name)
@@ -15,7 +15,7 @@ struct StaticMeshDefinition
 	std::string m_yAxis = "left";
 	std::string m_zAxis = "up";
 
-	static void InitializeStaticMeshDefinitions(const char* path);
+	static void InitializeStaticMeshDefinitions(const char* path); // Reads "<path>.bin" instead of the XML while it is up to date
 
 	static StaticMeshDefinition const& GetDefinition(std::string name);
 	static std::vector<StaticMeshDefinition> s_meshDefs;
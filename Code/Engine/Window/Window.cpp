@@ -5,12 +5,35 @@
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystem.hpp"
 #include "ThirdParty/imgui/imgui.h"
 #include "ThirdParty/imgui/backends/imgui_impl_win32.h"
 
 
 Window* Window::s_mainWindow = nullptr;
 extern DevConsole* g_theDevConsole;
+extern EventSystem* g_theEventSystem;
+
+// Named input events; hash their names once
+static constexpr EventID EVENT_MOUSE_WHEEL("MouseWheel");
+static constexpr EventID EVENT_KEY_PRESSED("KeyPressed");
+static constexpr EventID EVENT_KEY_RELEASED("KeyReleased");
+static constexpr EventID EVENT_CHAR_INPUT("CharInput");
+
+// Key and char input goes out as a typed event, and also by name for subscribers that still use
+// SubscribeEventCallbackFunction("KeyPressed", ...) unless a typed subscriber consumed it
+template <typename TEvent>
+static void FireInputEvent(TEvent const& inputEvent, EventID namedEventID, char const* argName, int argValue)
+{
+	if (g_theEventSystem)
+	{
+		g_theEventSystem->FireTypedAndNamed(inputEvent, namedEventID, [argName, argValue](EventArgs& args)
+			{
+				args.SetValue(argName, Stringf("%d", argValue));
+				return true;
+			});
+	}
+}
 
 //-----------------------------------------------------------------------------------------------
 // Handles Windows (Win32) messages/events; i.e. the OS is trying to tell us something happened.
@@ -42,50 +65,42 @@ LRESULT CALLBACK WindowsMessageHandlingProcedure(HWND windowHandle, UINT wmMessa
 	case WM_KEYDOWN:
 	{
 		if (!wantKbd) {
-			EventArgs args;
-			args.SetValue("KeyCode", Stringf("%d", (unsigned char)wParam));
-			FireEvent("KeyPressed", args);
+			FireInputEvent(KeyPressedEvent{ (unsigned char)wParam }, EVENT_KEY_PRESSED, "KeyCode", (unsigned char)wParam);
 		}
 		return 0;
 	}
 	case WM_KEYUP:
 	{
 		if (!wantKbd) {
-			EventArgs args;
-			args.SetValue("KeyCode", Stringf("%d", (unsigned char)wParam));
-			FireEvent("KeyReleased", args);
+			FireInputEvent(KeyReleasedEvent{ (unsigned char)wParam }, EVENT_KEY_RELEASED, "KeyCode", (unsigned char)wParam);
 		}
 		return 0;
 	}
 	case WM_LBUTTONDOWN:
 	{
 		if (!wantMouse) {
-			EventArgs args; args.SetValue("KeyCode", Stringf("%d", (unsigned char)KEYCODE_LEFT_MOUSE));
-			FireEvent("KeyPressed", args);
+			FireInputEvent(KeyPressedEvent{ KEYCODE_LEFT_MOUSE }, EVENT_KEY_PRESSED, "KeyCode", (unsigned char)KEYCODE_LEFT_MOUSE);
 		}
 		return 0;
 	}
 	case WM_LBUTTONUP:
 	{
 		if (!wantMouse) {
-			EventArgs args; args.SetValue("KeyCode", Stringf("%d", (unsigned char)KEYCODE_LEFT_MOUSE));
-			FireEvent("KeyReleased", args);
+			FireInputEvent(KeyReleasedEvent{ KEYCODE_LEFT_MOUSE }, EVENT_KEY_RELEASED, "KeyCode", (unsigned char)KEYCODE_LEFT_MOUSE);
 		}
 		return 0;
 	}
 	case WM_RBUTTONDOWN:
 	{
 		if (!wantMouse) {
-			EventArgs args; args.SetValue("KeyCode", Stringf("%d", (unsigned char)KEYCODE_RIGHT_MOUSE));
-			FireEvent("KeyPressed", args);
+			FireInputEvent(KeyPressedEvent{ KEYCODE_RIGHT_MOUSE }, EVENT_KEY_PRESSED, "KeyCode", (unsigned char)KEYCODE_RIGHT_MOUSE);
 		}
 		return 0;
 	}
 	case WM_RBUTTONUP:
 	{
 		if (!wantMouse) {
-			EventArgs args; args.SetValue("KeyCode", Stringf("%d", (unsigned char)KEYCODE_RIGHT_MOUSE));
-			FireEvent("KeyReleased", args);
+			FireInputEvent(KeyReleasedEvent{ KEYCODE_RIGHT_MOUSE }, EVENT_KEY_RELEASED, "KeyCode", (unsigned char)KEYCODE_RIGHT_MOUSE);
 		}
 		return 0;
 	}
@@ -94,7 +109,7 @@ LRESULT CALLBACK WindowsMessageHandlingProcedure(HWND windowHandle, UINT wmMessa
 		if (!wantMouse) {
 			short delta = GET_WHEEL_DELTA_WPARAM(wParam);
 			EventArgs args; args.SetValue("WheelDelta", Stringf("%d", (int)delta));
-			FireEvent("MouseWheel", args);
+			FireEvent(EVENT_MOUSE_WHEEL, args);
 		}
 		return 0;
 	}
@@ -102,9 +117,7 @@ LRESULT CALLBACK WindowsMessageHandlingProcedure(HWND windowHandle, UINT wmMessa
 	{
 		if (!wantKbd && g_theDevConsole && g_theDevConsole->IsOpen())
 		{
-			EventArgs args;
-			args.SetValue("Char", Stringf("%d", (unsigned char)wParam));
-			FireEvent("CharInput", args);
+			FireInputEvent(CharInputEvent{ (char)wParam }, EVENT_CHAR_INPUT, "Char", (unsigned char)wParam);
 		}
 		return 0;
 	}